@@ -0,0 +1,222 @@
+/****************************************************************************
+ * File: analyze.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of batch EPD analysis.
+    - The input file itself is the work queue: a worker takes the next line
+      under a lock, searches it without holding any lock and appends its
+      result under a second lock, flushing so results stream out as they
+      complete. Nothing is read ahead, so files of any size work.
+    - Each position starts from a cleared TT and fresh history, so its
+      result doesn't depend on which worker searched it or what came before.
+*/
+
+#include "analyze.h"
+#include "board.h"
+#include "search.h"
+#include "transposition.h"
+#include "misc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EPD_LINE_SIZE 1024
+
+/* State shared by all workers */
+typedef struct {
+    FILE* in;
+    FILE* out;
+    pthread_mutex_t inLock;   /* Guards in and lineNumber */
+    pthread_mutex_t outLock;  /* Guards out and the totals */
+    int lineNumber;
+    int depth;
+    size_t ttEntries;
+    uint64_t positions;
+    uint64_t nodes;
+} AnalyzeShared;
+
+typedef struct {
+    Board board;
+    SearchInfo info;
+    TransTable tt;
+    AnalyzeShared* shared;
+} AnalyzeWorker;
+
+/* Next input line and its number, or false at the end of the file */
+static bool NextLine(AnalyzeShared* shared, char* line, int* number)
+{
+    pthread_mutex_lock(&shared->inLock);
+    bool ok = fgets(line, EPD_LINE_SIZE, shared->in) != NULL;
+    *number = ++shared->lineNumber;
+    pthread_mutex_unlock(&shared->inLock);
+    return ok;
+}
+
+/*
+    SplitEpd:
+    - Copies the four position fields into fen (EPD has no clocks; a FEN
+      line's clocks are left to SetFen) and the id operation, if any, into
+      id. Returns false for blank and comment lines.
+*/
+static bool SplitEpd(const char* line, char* fen, size_t fenSize, char* id, size_t idSize)
+{
+    const char* p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (!*p || *p == '\n' || *p == '\r' || *p == '#') {
+        return false;
+    }
+
+    size_t len = 0;
+    for (int field = 0; field < 4 && *p && *p != '\n' && *p != '\r'; field++) {
+        while (*p && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' && len + 2 < fenSize) {
+            fen[len++] = *p++;
+        }
+        while (*p == ' ' || *p == '\t') p++;
+        if (field < 3) fen[len++] = ' ';
+    }
+    fen[len] = '\0';
+
+    id[0] = '\0';
+    const char* op = strstr(p, "id \"");
+    if (op) {
+        op += 4;
+        size_t n = 0;
+        while (op[n] && op[n] != '"' && n + 1 < idSize) n++;
+        memcpy(id, op, n);
+        id[n] = '\0';
+    }
+    return true;
+}
+
+/* A position the search can't handle: not one king per side, or the side
+   not to move in check */
+static bool IsSearchable(const Board* b)
+{
+    if (PopCount(b->pieceBB[W_KING]) != 1 || PopCount(b->pieceBB[B_KING]) != 1) {
+        return false;
+    }
+    return !IsSquareAttacked(b, KingSquare(b, b->side ^ 1), b->side);
+}
+
+static void* WorkerMain(void* arg)
+{
+    AnalyzeWorker* w = (AnalyzeWorker*)arg;
+    AnalyzeShared* shared = w->shared;
+    char line[EPD_LINE_SIZE], fen[256], id[128], result[EPD_LINE_SIZE + 128];
+    int number;
+
+    while (NextLine(shared, line, &number)) {
+        if (!SplitEpd(line, fen, sizeof(fen), id, sizeof(id))) {
+            continue;
+        }
+        if (!id[0]) {
+            snprintf(id, sizeof(id), "%d", number);
+        }
+
+        SetFen(&w->board, line, false);
+        if (!IsSearchable(&w->board)) {
+            pthread_mutex_lock(&shared->outLock);
+            fprintf(shared->out, "%s id \"%s\"; error \"illegal position\";\n", fen, id);
+            fflush(shared->out);
+            pthread_mutex_unlock(&shared->outLock);
+            continue;
+        }
+
+        ClearTranspositionTable(&w->tt);
+        ClearSearchInfo(&w->info);
+        w->info.depth  = shared->depth;
+        w->info.tt     = &w->tt;
+        w->info.report = false;
+        SearchPosition(&w->board, &w->info);
+
+        char moveStr[6] = "0000";
+        if (w->info.bestMove != NOMOVE) {
+            MoveToUciMove(w->info.bestMove, moveStr);
+        }
+        int score = w->info.bestScore;
+        int len = snprintf(result, sizeof(result), "%s acd %d; acn %llu; ce %d;",
+                           fen, w->info.completedDepth,
+                           (unsigned long long)w->info.nodes, score);
+        if (abs(score) > MATE - MAX_DEPTH) {
+            int moves = (score > 0) ? (MATE - score + 1) / 2 : -(MATE + score) / 2;
+            len += snprintf(result + len, sizeof(result) - len, " dm %d;", moves);
+        }
+        snprintf(result + len, sizeof(result) - len, " bestmove %s; id \"%s\";", moveStr, id);
+
+        pthread_mutex_lock(&shared->outLock);
+        fprintf(shared->out, "%s\n", result);
+        fflush(shared->out);
+        shared->positions++;
+        shared->nodes += w->info.nodes;
+        pthread_mutex_unlock(&shared->outLock);
+    }
+    return NULL;
+}
+
+static bool InitWorker(void* worker, int index, void* arg)
+{
+    AnalyzeWorker* w = (AnalyzeWorker*)worker;
+    AnalyzeShared* shared = (AnalyzeShared*)arg;
+    (void)index;
+
+    w->shared = shared;
+    InitBoard(&w->board);
+    InitTranspositionTable(&w->tt, shared->ttEntries);
+    return w->tt.buckets != NULL;
+}
+
+static void ReleaseWorker(void* worker)
+{
+    FreeTranspositionTable(&((AnalyzeWorker*)worker)->tt);
+}
+
+/*
+    RunEpdAnalysis:
+    - Opens the files, runs the workers until the input is exhausted and
+      reports totals.
+*/
+bool RunEpdAnalysis(const AnalyzeOptions* opts)
+{
+    AnalyzeShared shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.depth     = (opts->depth > 0) ? opts->depth : ANALYZE_DEFAULT_DEPTH;
+    shared.ttEntries = opts->hashMb * 1024 * 1024 / sizeof(TTEntry);
+
+    shared.in = fopen(opts->epdPath, "r");
+    if (!shared.in) {
+        fprintf(stderr, "Error: Unable to open %s\n", opts->epdPath);
+        return false;
+    }
+    shared.out = opts->outPath ? fopen(opts->outPath, "w") : stdout;
+    if (!shared.out) {
+        fprintf(stderr, "Error: Unable to open %s\n", opts->outPath);
+        fclose(shared.in);
+        return false;
+    }
+    pthread_mutex_init(&shared.inLock, NULL);
+    pthread_mutex_init(&shared.outLock, NULL);
+
+    static const WorkerPool pool = {
+        "analysis", sizeof(AnalyzeWorker), InitWorker, WorkerMain, ReleaseWorker
+    };
+    int threads = (opts->threads > MAX_THREADS) ? MAX_THREADS : opts->threads;
+    int64_t startTime = GetTimeMs();
+    int ran = RunWorkers(&pool, threads, &shared, &startTime);
+    int64_t elapsed = GetTimeMs() - startTime;
+
+    fprintf(stderr, "Positions: %llu  Nodes: %llu  Time: %lld ms  NPS: %llu  Positions/s: %.1f\n",
+            (unsigned long long)shared.positions, (unsigned long long)shared.nodes,
+            (long long)elapsed,
+            (unsigned long long)(elapsed > 0 ? shared.nodes * 1000 / (uint64_t)elapsed : shared.nodes),
+            elapsed > 0 ? shared.positions * 1000.0 / elapsed : (double)shared.positions);
+
+    pthread_mutex_destroy(&shared.inLock);
+    pthread_mutex_destroy(&shared.outLock);
+    fclose(shared.in);
+    if (shared.out != stdout) {
+        fclose(shared.out);
+    }
+    return ran > 0;
+}
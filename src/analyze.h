@@ -0,0 +1,40 @@
+/****************************************************************************
+ * File: analyze.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for batch EPD analysis (./bear analyze).
+    - Scores every position of an EPD or FEN file to a fixed depth with a
+      pool of worker threads. Each worker owns its Board, SearchInfo and a
+      small TransTable and runs single-threaded searches, so positions are
+      searched independently and in parallel.
+    - Results are written as they complete, one EPD line per position
+      (so in completion order, not input order):
+        <fen> acd <depth>; acn <nodes>; ce <score>; [dm <moves>;] bestmove <uci>; id "<id>";
+      where id is copied from the input or is the input line number.
+
+    Exports:
+      1) bool RunEpdAnalysis(const AnalyzeOptions* opts);
+*/
+
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ANALYZE_DEFAULT_DEPTH    10
+#define ANALYZE_DEFAULT_HASH_MB  16 /* Per worker */
+
+typedef struct {
+    const char* epdPath;  /* Input, one position per line ("#" starts a comment) */
+    const char* outPath;  /* Output file, or NULL for stdout */
+    int depth;            /* Search depth per position */
+    int threads;          /* Worker threads */
+    size_t hashMb;        /* TT size of each worker */
+} AnalyzeOptions;
+
+/* Run the analysis; prints totals to stderr. False if a file can't be opened. */
+bool RunEpdAnalysis(const AnalyzeOptions* opts);
+
+#endif /* ANALYZE_H */
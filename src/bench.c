@@ -0,0 +1,140 @@
+/****************************************************************************
+ * File: bench.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of the search benchmark.
+    - Positions: openings, sharp middlegames and endgames (many of them
+      the common engine bench positions), so the node count covers move
+      ordering, pruning, the TT and both evaluation phases.
+    - The table is searched with the engine's current evaluation (NNUE if
+      a net is loaded and enabled), so the signature depends on the net.
+*/
+
+#include "bench.h"
+#include "board.h"
+#include "search.h"
+#include "transposition.h"
+#include "misc.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char* BenchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "rnbqkb1r/pp1p1ppp/4pn2/2p5/2PP4/5N2/PP2PPPP/RNBQKB1R w KQkq - 0 4",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+    "rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq d6 0 2",
+    "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2N2N2/PPPP1PPP/R1BQK2R w KQkq - 6 5",
+    "rnbq1rk1/ppp1ppbp/3p1np1/8/2PPP3/2N2N2/PP3PPP/R1BQKB1R w KQ - 1 6",
+    "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+    "r2qk2r/pp1nbppp/2p1pn2/3p4/2PP4/2N1PN2/PPQ2PPP/R1B1KB1R w KQkq - 2 8",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+    "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+    "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+    "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+    "3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+    "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+    "r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "2r3k1/pp3ppp/2n1b3/q2pP3/3P4/P1r2N2/1P1QBPPP/R4RK1 w - - 0 18",
+    "r1b2rk1/2q1bppp/p2ppn2/1p6/3BPP2/2NB4/PPPQ2PP/2KR3R w - - 2 13",
+    "2kr3r/pp1q1ppp/5n2/1Nb5/2Pp1B2/7Q/P4PPP/1R3RK1 w - - 0 1",
+    "r2q1rk1/pb1nbppp/1p2pn2/2pp4/2PP4/1PN1PN2/PB2BPPP/R2Q1RK1 w - - 0 10",
+    "1r2r1k1/5ppp/p1p5/3p4/P2P1B2/2P2P2/6PP/R3R1K1 w - - 0 25",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 w - - 7 23",
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+    "3r2k1/1p3ppp/2pq4/p1n5/P6P/1P6/1PB2QP1/1K2R3 w - - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+    "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+    "8/8/8/8/8/6k1/6p1/6K1 w - - 0 1",
+    "7k/7P/6K1/8/3B4/8/8/8 b - - 0 1",
+    "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1",
+    "8/5p2/8/2k3P1/p3K3/8/1P6/8 b - - 0 1",
+    "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+    "6k1/5pp1/8/8/8/8/5PP1/3R2K1 w - - 0 1",
+};
+
+#define BENCH_COUNT ((int)(sizeof(BenchPositions) / sizeof(BenchPositions[0])))
+
+/*
+    RunBench:
+    - Searches every position in turn with its own cleared hash table
+      and search state; prints one line per position and the totals.
+*/
+uint64_t RunBench(int depth, int threads, size_t hashMb)
+{
+    if (depth <= 0)   depth   = BENCH_DEFAULT_DEPTH;
+    if (threads <= 0) threads = BENCH_DEFAULT_THREADS;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if (hashMb == 0)  hashMb  = BENCH_DEFAULT_HASH_MB;
+
+    TransTable tt;
+    InitTranspositionTable(&tt, hashMb * 1024 * 1024 / sizeof(TTEntry));
+    if (!tt.buckets) {
+        return 0;
+    }
+
+    /* Board and SearchInfo are large: keep them off the stack */
+    Board* board = (Board*)malloc(sizeof(Board));
+    SearchInfo* info = (SearchInfo*)malloc(sizeof(SearchInfo));
+    if (!board || !info) {
+        fprintf(stderr, "Error: Unable to allocate the benchmark state\n");
+        free(board);
+        free(info);
+        FreeTranspositionTable(&tt);
+        return 0;
+    }
+
+    uint64_t totalNodes = 0;
+    int64_t startTime = GetTimeMs();
+
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        SetFen(board, BenchPositions[i], false);
+        ClearTranspositionTable(&tt);
+        ClearSearchInfo(info);
+        info->depth   = depth;
+        info->threads = threads;
+        info->tt      = &tt;
+        info->report  = false;
+        SearchPosition(board, info);
+
+        char moveStr[6] = "0000";
+        if (info->bestMove != NOMOVE) {
+            MoveToUciMove(info->bestMove, moveStr);
+        }
+        printf("Position %2d/%d: %-5s %10llu nodes\n", i + 1, BENCH_COUNT, moveStr,
+               (unsigned long long)info->nodes);
+        totalNodes += info->nodes;
+    }
+
+    int64_t elapsed = GetTimeMs() - startTime;
+    printf("===========================\n");
+    printf("Total time (ms) : %lld\n", (long long)elapsed);
+    printf("Nodes searched  : %llu\n", (unsigned long long)totalNodes);
+    printf("Nodes/second    : %llu\n",
+           (unsigned long long)(elapsed > 0 ? totalNodes * 1000 / (uint64_t)elapsed : totalNodes));
+    fflush(stdout);
+
+    free(board);
+    free(info);
+    FreeTranspositionTable(&tt);
+    return totalNodes;
+}
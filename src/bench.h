@@ -0,0 +1,34 @@
+/****************************************************************************
+ * File: bench.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the search benchmark ("bench" UCI command, ./bear bench).
+    - Searches a fixed set of positions to a fixed depth and reports the
+      total node count, time and nodes per second.
+    - With one thread the node count is a functional signature: every
+      position starts from a cleared private hash table and fresh search
+      state, so it only changes when the search or evaluation does.
+      Patches that are meant to be speedups only must leave it unchanged.
+
+    Exports:
+      1) uint64_t RunBench(int depth, int threads, size_t hashMb);
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BENCH_DEFAULT_DEPTH    11
+#define BENCH_DEFAULT_THREADS  1
+#define BENCH_DEFAULT_HASH_MB  16
+
+/*
+   Run the benchmark (a value <= 0 selects the default) and print the
+   results to stdout. Returns the total node count.
+*/
+uint64_t RunBench(int depth, int threads, size_t hashMb);
+
+#endif /* BENCH_H */
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * File: bitboard.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of the bitboard attack tables.
+    - Knight, king and pawn attacks are precomputed per square.
+    - Bishop and rook attacks come from magic-bitboard tables: each
+      square's relevant occupancy is hashed (magic multiply and shift)
+      into its slice of BishopTable/RookTable, filled once at startup by
+      walking the rays for every blocker subset.
+    - The magics are searched at startup from fixed per-rank seeds, so
+      every run finds the same numbers after a few attempts.
+    - Built with make PEXT=1 (USE_PEXT), the index is the BMI2 PEXT of
+      the occupancy and mask instead and no magic search is needed.
+*/
+
+#include "bitboard.h"
+#include "defs.h"
+#include <string.h> /* For memset */
+
+Bitboard KnightAttacks[64];
+Bitboard KingAttacks[64];
+Bitboard PawnAttacks[2][64];
+Bitboard BetweenBB[64][64];
+Bitboard LineBB[64][64];
+
+Magic BishopMagics[64];
+Magic RookMagics[64];
+
+/* Shared attack tables: sum over squares of 2^(relevant bits) */
+static Bitboard BishopTable[5248];
+static Bitboard RookTable[102400];
+
+/* Direction vectors as (file, rank) steps */
+static const int KnightSteps[8][2] = {
+    { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+    { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 }
+};
+static const int KingSteps[8][2] = {
+    { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 },
+    { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }
+};
+static const int BishopSteps[4][2] = { { 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 } };
+static const int RookSteps[4][2]   = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+
+/* Returns the square at (file, rank) as a bitboard, or 0 if off the board */
+static Bitboard TargetBB(int file, int rank)
+{
+    if (file < 0 || file > 7 || rank < 0 || rank > 7) {
+        return 0ULL;
+    }
+    return SQ_BB(rank * 8 + file);
+}
+
+/*
+    SlidingAttacks:
+    - Walks each of the 4 rays from sq and collects the squares reached.
+    - Stops a ray after the first occupied square (which is included,
+      so captures and defended pieces both show up).
+*/
+static Bitboard SlidingAttacks(int sq, Bitboard occ, const int steps[4][2])
+{
+    Bitboard attacks = 0ULL;
+
+    for (int i = 0; i < 4; i++) {
+        int file = FILE_OF(sq) + steps[i][0];
+        int rank = RANK_OF(sq) + steps[i][1];
+        Bitboard target;
+        while ((target = TargetBB(file, rank)) != 0ULL) {
+            attacks |= target;
+            if (occ & target) {
+                break; /* Blocked */
+            }
+            file += steps[i][0];
+            rank += steps[i][1];
+        }
+    }
+
+    return attacks;
+}
+
+#ifndef USE_PEXT
+/* Per-rank generator seeds known to find all magics after few attempts */
+static const uint64_t MagicSeeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+/* xorshift64* generator used for the magic search */
+static uint64_t MagicRand(uint64_t* state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+#endif
+
+/*
+    InitMagics:
+    - For each square: builds the relevant-occupancy mask, enumerates every
+      subset of it (Carry-Rippler trick) with its reference attack set, and
+      fills the square's table slice.
+    - Without PEXT, tries sparse random multipliers until one maps all
+      subsets without a destructive collision.
+*/
+static void InitMagics(Magic magics[64], Bitboard* table, const int steps[4][2])
+{
+    static Bitboard reference[4096];
+#ifndef USE_PEXT
+    static Bitboard occupancy[4096];
+    static int epoch[4096];
+    int attempt = 0;
+#endif
+    Bitboard* next = table;
+
+#ifndef USE_PEXT
+    memset(epoch, 0, sizeof(epoch));
+#endif
+
+    for (int sq = 0; sq < 64; sq++) {
+        Magic* m = &magics[sq];
+
+        /* Edges only matter if the slider stands on them */
+        Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~RANK_BB(RANK_OF(sq)))
+                       | ((FILE_A_BB | FILE_H_BB) & ~FILE_BB(FILE_OF(sq)));
+        m->mask    = SlidingAttacks(sq, 0ULL, steps) & ~edges;
+        m->shift   = 64 - PopCount(m->mask);
+        m->attacks = next;
+
+        int size = 0;
+        Bitboard subset = 0ULL;
+        do {
+            reference[size] = SlidingAttacks(sq, subset, steps);
+#ifdef USE_PEXT
+            m->attacks[_pext_u64(subset, m->mask)] = reference[size];
+#else
+            occupancy[size] = subset;
+#endif
+            size++;
+            subset = (subset - m->mask) & m->mask;
+        } while (subset);
+
+        next += size;
+
+#ifndef USE_PEXT
+        /* Search for a magic; epoch[] marks which slots this attempt used */
+        uint64_t seed = MagicSeeds[RANK_OF(sq)];
+        for (int i = 0; i < size; ) {
+            do {
+                m->magic = MagicRand(&seed) & MagicRand(&seed) & MagicRand(&seed);
+            } while (PopCount((m->mask * m->magic) >> 56) < 6);
+
+            attempt++;
+            for (i = 0; i < size; i++) {
+                unsigned idx = MagicIndex(m, occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m->attacks[idx] = reference[i];
+                }
+                else if (m->attacks[idx] != reference[i]) {
+                    break; /* Destructive collision, try another magic */
+                }
+            }
+        }
+#endif
+    }
+}
+
+/*
+    InitBitboards:
+    - Precomputes knight, king and pawn attacks for every square,
+      then the bishop and rook magic tables, then the line tables.
+*/
+void InitBitboards(void)
+{
+    for (int sq = 0; sq < 64; sq++) {
+        int file = FILE_OF(sq);
+        int rank = RANK_OF(sq);
+
+        KnightAttacks[sq] = 0ULL;
+        KingAttacks[sq]   = 0ULL;
+        for (int i = 0; i < 8; i++) {
+            KnightAttacks[sq] |= TargetBB(file + KnightSteps[i][0], rank + KnightSteps[i][1]);
+            KingAttacks[sq]   |= TargetBB(file + KingSteps[i][0],   rank + KingSteps[i][1]);
+        }
+
+        PawnAttacks[WHITE][sq] = TargetBB(file - 1, rank + 1) | TargetBB(file + 1, rank + 1);
+        PawnAttacks[BLACK][sq] = TargetBB(file - 1, rank - 1) | TargetBB(file + 1, rank - 1);
+    }
+
+    InitMagics(BishopMagics, BishopTable, BishopSteps);
+    InitMagics(RookMagics, RookTable, RookSteps);
+
+    for (int s1 = 0; s1 < 64; s1++) {
+        for (int s2 = 0; s2 < 64; s2++) {
+            BetweenBB[s1][s2] = LineBB[s1][s2] = 0ULL;
+            if (s1 == s2) continue;
+
+            if (RookAttacks(s1, 0ULL) & SQ_BB(s2)) {
+                LineBB[s1][s2]    = (RookAttacks(s1, 0ULL) & RookAttacks(s2, 0ULL)) | SQ_BB(s1) | SQ_BB(s2);
+                BetweenBB[s1][s2] = RookAttacks(s1, SQ_BB(s2)) & RookAttacks(s2, SQ_BB(s1));
+            }
+            else if (BishopAttacks(s1, 0ULL) & SQ_BB(s2)) {
+                LineBB[s1][s2]    = (BishopAttacks(s1, 0ULL) & BishopAttacks(s2, 0ULL)) | SQ_BB(s1) | SQ_BB(s2);
+                BetweenBB[s1][s2] = BishopAttacks(s1, SQ_BB(s2)) & BishopAttacks(s2, SQ_BB(s1));
+            }
+        }
+    }
+}
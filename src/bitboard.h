@@ -0,0 +1,120 @@
+/****************************************************************************
+ * File: bitboard.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for 64-bit bitboard helpers.
+    - Squares are numbered 0..63 with a1 = 0, b1 = 1, ... h8 = 63,
+      so bit n of a bitboard stands for square n.
+    - Declares precomputed attack tables for leapers and pawns, plus
+      magic-bitboard lookups for sliding pieces given the board occupancy.
+    - Building with -DUSE_PEXT (and -mbmi2) indexes the slider tables with
+      the BMI2 PEXT instruction instead of a magic multiply.
+*/
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+#ifdef USE_PEXT
+#include <immintrin.h> /* For _pext_u64 */
+#endif
+
+typedef uint64_t Bitboard;
+
+/* Square / file / rank helpers */
+#define SQ_BB(sq)   (1ULL << (sq))
+#define FILE_OF(sq) ((sq) & 7)
+#define RANK_OF(sq) ((sq) >> 3)
+
+#define FILE_A_BB 0x0101010101010101ULL
+#define FILE_H_BB 0x8080808080808080ULL
+#define RANK_1_BB 0x00000000000000FFULL
+#define RANK_8_BB 0xFF00000000000000ULL
+#define FILE_BB(f) (FILE_A_BB << (f))
+#define RANK_BB(r) (RANK_1_BB << (8 * (r)))
+
+/* Number of set bits */
+static inline int PopCount(Bitboard bb)
+{
+    return __builtin_popcountll(bb);
+}
+
+/* Index of the least significant set bit (bb must be non-zero) */
+static inline int Lsb(Bitboard bb)
+{
+    return __builtin_ctzll(bb);
+}
+
+/* Returns the least significant set bit and clears it from *bb */
+static inline int PopLsb(Bitboard* bb)
+{
+    int sq = Lsb(*bb);
+    *bb &= *bb - 1;
+    return sq;
+}
+
+/* Precomputed attack tables, filled in by InitBitboards() */
+extern Bitboard KnightAttacks[64];
+extern Bitboard KingAttacks[64];
+extern Bitboard PawnAttacks[2][64]; /* [side][square] */
+
+/*
+   Line geometry between two squares, both 0 unless the squares share a
+   rank, file or diagonal:
+    - BetweenBB: squares strictly between s1 and s2
+    - LineBB:    the whole line through s1 and s2 (edge to edge)
+*/
+extern Bitboard BetweenBB[64][64];
+extern Bitboard LineBB[64][64];
+
+/*
+   Magic-bitboard entry for one slider on one square.
+    - mask:    relevant occupancy (the rays, without the board edges)
+    - magic:   multiplier that maps every masked occupancy to a unique index
+    - attacks: this square's slice of the shared attack table
+    - shift:   64 minus the number of relevant bits
+*/
+typedef struct {
+    Bitboard  mask;
+    Bitboard  magic;
+    Bitboard* attacks;
+    unsigned  shift;
+} Magic;
+
+extern Magic BishopMagics[64];
+extern Magic RookMagics[64];
+
+/* Fill the attack tables and find the magics. Must be called once at startup. */
+void InitBitboards(void);
+
+/* Index into a square's attack table for the given occupancy */
+static inline unsigned MagicIndex(const Magic* m, Bitboard occ)
+{
+#ifdef USE_PEXT
+    return (unsigned)_pext_u64(occ, m->mask);
+#else
+    return (unsigned)(((occ & m->mask) * m->magic) >> m->shift);
+#endif
+}
+
+/* Sliding piece attacks from sq, stopping at (and including) blockers in occ */
+static inline Bitboard BishopAttacks(int sq, Bitboard occ)
+{
+    const Magic* m = &BishopMagics[sq];
+    return m->attacks[MagicIndex(m, occ)];
+}
+
+static inline Bitboard RookAttacks(int sq, Bitboard occ)
+{
+    const Magic* m = &RookMagics[sq];
+    return m->attacks[MagicIndex(m, occ)];
+}
+
+static inline Bitboard QueenAttacks(int sq, Bitboard occ)
+{
+    return BishopAttacks(sq, occ) | RookAttacks(sq, occ);
+}
+
+#endif /* BITBOARD_H */
@@ -6,13 +6,49 @@
 */
 
 #include "board.h"
+#include "zobrist.h"
+#include "evaluate.h"
+#include "movegen.h"
+#include "log.h"
 #include <ctype.h>  /* For isdigit() */
-#include <string.h> /* For strtok(), strncpy(), etc. */
+#include <string.h> /* For memset(), strlen(), etc. */
 #include <stdio.h>  /* For logging */
+#include <stdlib.h> /* For atoi() */
 
-/* Converts file (0-7) and rank (0-7) to 120-based index */
-int FRTo120(int file, int rank) {
-    return (rank + 2) * 10 + (file + 1);
+/*
+   Castling rights that survive a move touching each square.
+   Moving from or to a king or rook home square clears the matching rights.
+*/
+static const int CastlePermMask[BOARD_SIZE] = {
+    13, 15, 15, 15, 12, 15, 15, 14,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     7, 15, 15, 15,  3, 15, 15, 11
+};
+
+/* Converts file (0-7) and rank (0-7) to a 0..63 square index */
+int FRToSq(int file, int rank) {
+    return rank * 8 + file;
+}
+
+/* Rebuild all bitboards from the pieces[] array */
+static void UpdateBitboards(Board* b)
+{
+    memset(b->pieceBB, 0, sizeof(b->pieceBB));
+    memset(b->colorBB, 0, sizeof(b->colorBB));
+
+    for(int sq = 0; sq < BOARD_SIZE; sq++) {
+        int piece = b->pieces[sq];
+        if(piece != EMPTY) {
+            b->pieceBB[piece] |= SQ_BB(sq);
+            b->colorBB[PieceColor(piece)] |= SQ_BB(sq);
+        }
+    }
+    b->colorBB[BOTH] = b->colorBB[WHITE] | b->colorBB[BLACK];
 }
 
 /* Initialize the board to the standard starting position */
@@ -24,41 +60,75 @@ void InitBoard(Board* b)
     }
 
     /* Set up white pieces */
-    b->pieces[FRTo120(0,0)] = W_ROOK;
-    b->pieces[FRTo120(1,0)] = W_KNIGHT;
-    b->pieces[FRTo120(2,0)] = W_BISHOP;
-    b->pieces[FRTo120(3,0)] = W_QUEEN;
-    b->pieces[FRTo120(4,0)] = W_KING;
-    b->pieces[FRTo120(5,0)] = W_BISHOP;
-    b->pieces[FRTo120(6,0)] = W_KNIGHT;
-    b->pieces[FRTo120(7,0)] = W_ROOK;
+    b->pieces[FRToSq(0,0)] = W_ROOK;
+    b->pieces[FRToSq(1,0)] = W_KNIGHT;
+    b->pieces[FRToSq(2,0)] = W_BISHOP;
+    b->pieces[FRToSq(3,0)] = W_QUEEN;
+    b->pieces[FRToSq(4,0)] = W_KING;
+    b->pieces[FRToSq(5,0)] = W_BISHOP;
+    b->pieces[FRToSq(6,0)] = W_KNIGHT;
+    b->pieces[FRToSq(7,0)] = W_ROOK;
     for(int f = 0; f < 8; f++) {
-        b->pieces[FRTo120(f,1)] = W_PAWN;
+        b->pieces[FRToSq(f,1)] = W_PAWN;
     }
 
     /* Set up black pieces */
-    b->pieces[FRTo120(0,7)] = B_ROOK;
-    b->pieces[FRTo120(1,7)] = B_KNIGHT;
-    b->pieces[FRTo120(2,7)] = B_BISHOP;
-    b->pieces[FRTo120(3,7)] = B_QUEEN;
-    b->pieces[FRTo120(4,7)] = B_KING;
-    b->pieces[FRTo120(5,7)] = B_BISHOP;
-    b->pieces[FRTo120(6,7)] = B_KNIGHT;
-    b->pieces[FRTo120(7,7)] = B_ROOK;
+    b->pieces[FRToSq(0,7)] = B_ROOK;
+    b->pieces[FRToSq(1,7)] = B_KNIGHT;
+    b->pieces[FRToSq(2,7)] = B_BISHOP;
+    b->pieces[FRToSq(3,7)] = B_QUEEN;
+    b->pieces[FRToSq(4,7)] = B_KING;
+    b->pieces[FRToSq(5,7)] = B_BISHOP;
+    b->pieces[FRToSq(6,7)] = B_KNIGHT;
+    b->pieces[FRToSq(7,7)] = B_ROOK;
     for(int f = 0; f < 8; f++) {
-        b->pieces[FRTo120(f,6)] = B_PAWN;
+        b->pieces[FRToSq(f,6)] = B_PAWN;
     }
 
     /* Set side to move */
     b->side = WHITE;
 
     /* No en passant square */
-    b->enPas = EMPTY;
+    b->enPas = NO_SQ;
 
     /* All castling rights available */
     b->castlePerm = WKCA | WQCA | BKCA | BQCA;
 
-    LogMessage(LOG_DEBUG, "Board initialized to standard starting position.\n");
+    /* Fresh game: bitboards, key and eval totals from scratch, empty history */
+    UpdateBitboards(b);
+    b->fiftyMove = 0;
+    b->pliesFromNull = 0;
+    b->ply = 0;
+    b->hisPly = 0;
+    b->posKey = GeneratePosKey(b);
+    b->pawnKey = GeneratePawnKey(b);
+    ComputeEvalTotals(b, &b->psqtMg, &b->psqtEg, &b->phase);
+    if(NnueEnabled) NnueRefresh(b);
+
+    LogDebug("Board initialized to standard starting position.\n");
+}
+
+/*
+   Copies the next space-separated field of *text into out and advances
+   *text past it. Returns NULL when there are no fields left.
+   (Unlike strtok this keeps no hidden state, so callers that are
+   themselves tokenizing with strtok are not disturbed.)
+*/
+static char* NextField(const char** text, char* out, size_t size)
+{
+    const char* p = *text;
+    size_t len = 0;
+
+    while(*p == ' ') p++;
+    if(*p == '\0') return NULL;
+
+    while(*p && *p != ' ') {
+        if(len + 1 < size) out[len++] = *p;
+        p++;
+    }
+    out[len] = '\0';
+    *text = p;
+    return out;
 }
 
 /* Set the board position based on a FEN string */
@@ -70,11 +140,10 @@ void SetFen(Board* b, const char* fen, bool debugMode)
     /* Example FEN parsing logic */
     /* Split FEN into fields: piece placement, active color, castling availability, en passant, halfmove clock, fullmove number */
 
-    char copy[1024];
-    strncpy(copy, fen, sizeof(copy));
-    copy[sizeof(copy)-1] = '\0'; /* Ensure null-termination */
+    const char* cursor = fen;
+    char field[128];
 
-    char* token = strtok(copy, " ");
+    char* token = NextField(&cursor, field, sizeof(field));
     if(!token) return;
 
     /* Piece placement */
@@ -89,20 +158,20 @@ void SetFen(Board* b, const char* fen, bool debugMode)
         }
         if(isdigit(c)) {
             int emptySquares = c - '0';
-            for(int e = 0; e < emptySquares; e++) {
-                b->pieces[FRTo120(file, rank)] = EMPTY;
+            for(int e = 0; e < emptySquares && file < 8; e++) {
+                b->pieces[FRToSq(file, rank)] = EMPTY;
                 file++;
             }
         }
-        else {
+        else if(file < 8) {
             int piece = CharToPiece(c);
-            b->pieces[FRTo120(file, rank)] = piece;
+            b->pieces[FRToSq(file, rank)] = piece;
             file++;
         }
     }
 
     /* Active color */
-    token = strtok(NULL, " ");
+    token = NextField(&cursor, field, sizeof(field));
     if(token && token[0] == 'b') {
         b->side = BLACK;
     }
@@ -111,7 +180,7 @@ void SetFen(Board* b, const char* fen, bool debugMode)
     }
 
     /* Castling availability */
-    token = strtok(NULL, " ");
+    token = NextField(&cursor, field, sizeof(field));
     b->castlePerm = 0;
     if(token) {
         for(int i = 0; i < strlen(token); i++) {
@@ -122,26 +191,36 @@ void SetFen(Board* b, const char* fen, bool debugMode)
                 case 'q': b->castlePerm |= BQCA; break;
                 case '-': /* No castling */ break;
                 default:
-                    LogMessage(LOG_WARN, "Unknown castling character: %c\n", token[i]);
+                    LogWarn("Unknown castling character: %c\n", token[i]);
                     break;
             }
         }
     }
 
     /* En passant target square */
-    token = strtok(NULL, " ");
-    if(token && token[0] != '-') {
+    token = NextField(&cursor, field, sizeof(field));
+    if(token && token[0] >= 'a' && token[0] <= 'h' && token[1] >= '1' && token[1] <= '8') {
         int file = token[0] - 'a';
         int rank = token[1] - '1';
-        b->enPas = FRTo120(file, rank);
+        b->enPas = FRToSq(file, rank);
     }
     else {
-        b->enPas = EMPTY;
+        b->enPas = NO_SQ;
     }
 
-    /* Halfmove clock and fullmove number are ignored for now */
+    /* Halfmove clock (the fullmove number is ignored) */
+    token = NextField(&cursor, field, sizeof(field));
+    if(token && isdigit((unsigned char)token[0])) {
+        b->fiftyMove = atoi(token);
+    }
+
+    UpdateBitboards(b);
+    b->posKey = GeneratePosKey(b);
+    b->pawnKey = GeneratePawnKey(b);
+    ComputeEvalTotals(b, &b->psqtMg, &b->psqtEg, &b->phase);
+    if(NnueEnabled) NnueRefresh(b);
 
-    LogMessage(LOG_DEBUG, "Board set from FEN: %s\n", fen);
+    LogDebug("Board set from FEN: %s\n", fen);
 }
 
 /* Convert character to piece code */
@@ -157,30 +236,335 @@ int CharToPiece(char c) {
     }
 }
 
-/* Placeholder: Implement a proper move legality check */
+/*
+    IsMoveLegal:
+    - True if the move (from, to and promotion piece) is one of the legal
+      moves in this position. Used to vet moves coming from the GUI.
+*/
 bool IsMoveLegal(Board* b, Move move) {
-    /* Implement your move legality logic here */
-    /* For now, assume all moves are legal */
-    return true;
+    Move moveList[MAX_POSITION_MOVES];
+    int moveCount = GenerateLegalMoves(b, moveList);
+
+    for(int i = 0; i < moveCount; i++) {
+        /* Compare squares and promotion; other flags follow from the board */
+        if(FromSq(moveList[i]) == FromSq(move) && ToSq(moveList[i]) == ToSq(move) &&
+           IsPromotion(moveList[i]) == IsPromotion(move) &&
+           (!IsPromotion(move) || PromotedType(moveList[i]) == PromotedType(move))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+   Square update helpers. The plain versions keep pieces[], the bitboards,
+   the keys and the evaluation totals in sync; the NoHash variants skip the
+   keys and totals and are used by UnmakeMove, which restores those from
+   the undo entry. The NNUE accumulator is too big for the undo entry, so
+   the NoHash variants update it in both directions.
+*/
+static inline void ClearPieceNoHash(Board* b, int sq)
+{
+    int piece = b->pieces[sq];
+    if(NnueEnabled) NnueSubPiece(&b->acc, piece, sq);
+    b->pieceBB[piece] ^= SQ_BB(sq);
+    b->colorBB[PieceColor(piece)] ^= SQ_BB(sq);
+    b->colorBB[BOTH] ^= SQ_BB(sq);
+    b->pieces[sq] = EMPTY;
+}
+
+static inline void AddPieceNoHash(Board* b, int sq, int piece)
+{
+    if(NnueEnabled) NnueAddPiece(&b->acc, piece, sq);
+    b->pieceBB[piece] |= SQ_BB(sq);
+    b->colorBB[PieceColor(piece)] |= SQ_BB(sq);
+    b->colorBB[BOTH] |= SQ_BB(sq);
+    b->pieces[sq] = piece;
+}
+
+static inline void MovePieceNoHash(Board* b, int from, int to)
+{
+    int piece = b->pieces[from];
+    Bitboard fromTo = SQ_BB(from) | SQ_BB(to);
+    if(NnueEnabled) NnueMovePiece(&b->acc, piece, from, to);
+    b->pieceBB[piece] ^= fromTo;
+    b->colorBB[PieceColor(piece)] ^= fromTo;
+    b->colorBB[BOTH] ^= fromTo;
+    b->pieces[to] = piece;
+    b->pieces[from] = EMPTY;
 }
 
-/* Placeholder: Implement making a move on the board */
-void MakeMove(Board* b, Move move) {
-    /* Implement your move making logic here */
-    /* Example: Move the piece */
-    b->pieces[move.to] = b->pieces[move.from];
-    b->pieces[move.from] = EMPTY;
+/* Remove the piece on sq, hashing it out of the key and the eval totals */
+static inline void ClearPiece(Board* b, int sq)
+{
+    int piece = b->pieces[sq];
+    b->posKey ^= PieceKeys[piece][sq];
+    if(PieceType(piece) == PAWN) b->pawnKey ^= PieceKeys[piece][sq];
+    b->psqtMg -= PsqtMg[piece][sq];
+    b->psqtEg -= PsqtEg[piece][sq];
+    b->phase  -= PhaseWeight[piece];
+    ClearPieceNoHash(b, sq);
+}
+
+/* Put piece on the (empty) square sq, hashing it into the key and the eval totals */
+static inline void AddPiece(Board* b, int sq, int piece)
+{
+    b->posKey ^= PieceKeys[piece][sq];
+    if(PieceType(piece) == PAWN) b->pawnKey ^= PieceKeys[piece][sq];
+    b->psqtMg += PsqtMg[piece][sq];
+    b->psqtEg += PsqtEg[piece][sq];
+    b->phase  += PhaseWeight[piece];
+    AddPieceNoHash(b, sq, piece);
+}
+
+/* Move the piece on from to the (empty) square to, updating the key and the eval totals */
+static inline void MovePiece(Board* b, int from, int to)
+{
+    int piece = b->pieces[from];
+    b->posKey ^= PieceKeys[piece][from] ^ PieceKeys[piece][to];
+    if(PieceType(piece) == PAWN) b->pawnKey ^= PieceKeys[piece][from] ^ PieceKeys[piece][to];
+    b->psqtMg += PsqtMg[piece][to] - PsqtMg[piece][from];
+    b->psqtEg += PsqtEg[piece][to] - PsqtEg[piece][from];
+    MovePieceNoHash(b, from, to);
+}
+
+/* Rook squares for a castling move, keyed by the king's target square */
+static void CastleRookSquares(int kingTo, int* rookFrom, int* rookTo)
+{
+    switch(kingTo) {
+        case  6: *rookFrom =  7; *rookTo =  5; break; /* g1: h1-f1 */
+        case  2: *rookFrom =  0; *rookTo =  3; break; /* c1: a1-d1 */
+        case 62: *rookFrom = 63; *rookTo = 61; break; /* g8: h8-f8 */
+        case 58: *rookFrom = 56; *rookTo = 59; break; /* c8: a8-d8 */
+        default: *rookFrom = *rookTo = 0; break;
+    }
+}
+
+/*
+    MakeMove:
+    - Plays a move on the board and pushes an undo entry with everything
+      needed to take it back (captured piece, castling rights, en passant
+      square, fifty-move clock, key).
+    - posKey is updated by XORing pieces, side, castling and en passant
+      keys in and out, never recomputed from scratch.
+*/
+void MakeMove(Board* b, Move move)
+{
+    int from = FromSq(move);
+    int to   = ToSq(move);
+    int piece = b->pieces[from];
+
+    ASSERT(b->hisPly < MAX_GAME_MOVES);
+
+    Undo* undo = &b->history[b->hisPly++];
+    undo->move       = move;
+    undo->captured   = EMPTY;
+    undo->castlePerm = b->castlePerm;
+    undo->enPas      = b->enPas;
+    undo->fiftyMove  = b->fiftyMove;
+    undo->pliesFromNull = b->pliesFromNull;
+    undo->posKey     = b->posKey;
+    undo->pawnKey    = b->pawnKey;
+    undo->psqtMg     = b->psqtMg;
+    undo->psqtEg     = b->psqtEg;
+    undo->phase      = b->phase;
+
+    b->fiftyMove++;
+    b->pliesFromNull++;
+    b->ply++;
+
+    /* Hash out the old en passant square and castling rights */
+    if(b->enPas != NO_SQ) {
+        b->posKey ^= EnPasKeys[b->enPas];
+    }
+    b->posKey ^= CastleKeys[b->castlePerm];
+
+    /* Captures */
+    if(IsEnPassant(move)) {
+        int capSq = (b->side == WHITE) ? to - 8 : to + 8;
+        undo->captured = b->pieces[capSq];
+        ClearPiece(b, capSq);
+    }
+    else if(b->pieces[to] != EMPTY) {
+        undo->captured = b->pieces[to];
+        ClearPiece(b, to);
+    }
+    if(undo->captured != EMPTY || piece == W_PAWN || piece == B_PAWN) {
+        b->fiftyMove = 0;
+    }
+
+    /* Castling also moves the rook */
+    if(IsCastle(move)) {
+        int rookFrom, rookTo;
+        CastleRookSquares(to, &rookFrom, &rookTo);
+        MovePiece(b, rookFrom, rookTo);
+    }
+
+    MovePiece(b, from, to);
 
     /* Handle promotions */
-    if(move.flag & (1 << 3)) { /* Promotion flag */
-        b->pieces[move.to] = move.promoted;
+    if(IsPromotion(move)) {
+        ClearPiece(b, to);
+        AddPiece(b, to, MakePiece(PromotedType(move), b->side));
     }
 
+    /* A double push leaves an en passant square behind the pawn */
+    b->enPas = NO_SQ;
+    if(IsPawnStart(move)) {
+        b->enPas = (b->side == WHITE) ? from + 8 : from - 8;
+        b->posKey ^= EnPasKeys[b->enPas];
+    }
+
+    /* Update castling rights */
+    b->castlePerm &= CastlePermMask[from] & CastlePermMask[to];
+    b->posKey ^= CastleKeys[b->castlePerm];
+
     /* Toggle side */
-    b->side = (b->side == WHITE) ? BLACK : WHITE;
+    b->side ^= 1;
+    b->posKey ^= SideKey;
+
+    ASSERT(CheckBoard(b));
+
+    LogTrace("Moved piece from %d to %d.\n", from, to);
+}
+
+/*
+    UnmakeMove:
+    - Pops the last undo entry and restores the position from it.
+    - Only the squares the move touched are written back; the scalar state
+      key and eval totals are copied straight from the entry, so no XOR
+      or add work is needed.
+*/
+void UnmakeMove(Board* b)
+{
+    ASSERT(b->hisPly > 0);
+
+    Undo* undo = &b->history[--b->hisPly];
+    Move move = undo->move;
+    int from = FromSq(move);
+    int to   = ToSq(move);
+
+    b->side ^= 1;
+    b->ply--;
+    b->castlePerm = undo->castlePerm;
+    b->enPas      = undo->enPas;
+    b->fiftyMove  = undo->fiftyMove;
+    b->pliesFromNull = undo->pliesFromNull;
+    b->posKey     = undo->posKey;
+    b->pawnKey    = undo->pawnKey;
+    b->psqtMg     = undo->psqtMg;
+    b->psqtEg     = undo->psqtEg;
+    b->phase      = undo->phase;
+
+    /* Move the piece back, turning a promoted piece back into a pawn */
+    if(IsPromotion(move)) {
+        ClearPieceNoHash(b, to);
+        AddPieceNoHash(b, from, MakePiece(PAWN, b->side));
+    }
+    else {
+        MovePieceNoHash(b, to, from);
+    }
+
+    if(IsCastle(move)) {
+        int rookFrom, rookTo;
+        CastleRookSquares(to, &rookFrom, &rookTo);
+        MovePieceNoHash(b, rookTo, rookFrom);
+    }
+
+    /* Put back any captured piece */
+    if(undo->captured != EMPTY) {
+        int capSq = to;
+        if(IsEnPassant(move)) {
+            capSq = (b->side == WHITE) ? to - 8 : to + 8;
+        }
+        AddPieceNoHash(b, capSq, undo->captured);
+    }
+
+    ASSERT(CheckBoard(b));
+}
+
+/*
+    MakeNullMove:
+    - Passes the turn without moving (for null-move pruning). Pushes an
+      undo entry with move NOMOVE, so repetition checks and the search can
+      tell a null move from a real one.
+    - pliesFromNull restarts, so positions before the null move are never
+      taken as repetitions of positions after it. The fifty-move clock
+      keeps counting: a null move doesn't reset it in the real game either.
+*/
+void MakeNullMove(Board* b)
+{
+    ASSERT(b->hisPly < MAX_GAME_MOVES);
+
+    Undo* undo = &b->history[b->hisPly++];
+    undo->move       = NOMOVE;
+    undo->captured   = EMPTY;
+    undo->castlePerm = b->castlePerm;
+    undo->enPas      = b->enPas;
+    undo->fiftyMove  = b->fiftyMove;
+    undo->pliesFromNull = b->pliesFromNull;
+    undo->posKey     = b->posKey;
+    undo->pawnKey    = b->pawnKey;
+    undo->psqtMg     = b->psqtMg;
+    undo->psqtEg     = b->psqtEg;
+    undo->phase      = b->phase;
+
+    b->ply++;
+    b->pliesFromNull = 0;
+    if(b->enPas != NO_SQ) {
+        b->posKey ^= EnPasKeys[b->enPas];
+        b->enPas = NO_SQ;
+    }
+    b->side ^= 1;
+    b->posKey ^= SideKey;
+
+    ASSERT(CheckBoard(b));
+}
+
+/* Takes back a MakeNullMove; only the scalar state changed */
+void UnmakeNullMove(Board* b)
+{
+    ASSERT(b->hisPly > 0 && b->history[b->hisPly - 1].move == NOMOVE);
+
+    Undo* undo = &b->history[--b->hisPly];
+    b->side ^= 1;
+    b->ply--;
+    b->enPas     = undo->enPas;
+    b->fiftyMove = undo->fiftyMove;
+    b->pliesFromNull = undo->pliesFromNull;
+    b->posKey    = undo->posKey;
+}
+
+#ifdef DEBUG
+/*
+    CheckBoard:
+    - Debug-only full consistency check: bitboards must match pieces[],
+      and the incremental keys, eval totals and NNUE accumulator must match
+      ones computed from scratch.
+*/
+bool CheckBoard(const Board* b)
+{
+    int mg, eg, phase;
+    Bitboard color[2] = { 0ULL, 0ULL };
+
+    for(int piece = W_PAWN; piece <= B_KING; piece++) {
+        Bitboard bb = b->pieceBB[piece];
+        color[PieceColor(piece)] |= bb;
+        while(bb) {
+            if(b->pieces[PopLsb(&bb)] != piece) return false;
+        }
+    }
+    for(int sq = 0; sq < BOARD_SIZE; sq++) {
+        int piece = b->pieces[sq];
+        if(piece != EMPTY && !(b->pieceBB[piece] & SQ_BB(sq))) return false;
+    }
+    if(color[WHITE] != b->colorBB[WHITE] || color[BLACK] != b->colorBB[BLACK]) return false;
+    if(b->colorBB[BOTH] != (color[WHITE] | color[BLACK])) return false;
 
-    /* Handle en passant, castling rights, etc. */
-    /* Implement your logic here */
+    ComputeEvalTotals(b, &mg, &eg, &phase);
+    if(mg != b->psqtMg || eg != b->psqtEg || phase != b->phase) return false;
+    if(NnueEnabled && !NnueCheckAccumulator(b)) return false;
 
-    LogMessage(LOG_DEBUG, "Moved piece from %d to %d.\n", move.from, move.to);
+    return b->posKey == GeneratePosKey(b) && b->pawnKey == GeneratePawnKey(b);
 }
+#endif
@@ -12,7 +12,10 @@
 
 #include "defs.h"
 #include "move.h" /* Include move.h to use Move structure */
+#include "bitboard.h"
+#include "nnue.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Constants for castling rights */
 #define WKCA (1 << 0) /* White Kingside Castling Allowed */
@@ -20,19 +23,94 @@
 #define BKCA (1 << 2) /* Black Kingside Castling Allowed */
 #define BQCA (1 << 3) /* Black Queenside Castling Allowed */
 
-/* Board structure */
+/* Maximum number of half-moves a game (plus search line) can reach */
+#define MAX_GAME_MOVES 2048
+
+/*
+   One entry of the undo-history stack. MakeMove pushes everything it
+   cannot recompute cheaply, so UnmakeMove restores the position in O(1)
+   without ever copying the board.
+*/
 typedef struct {
-    int pieces[BOARD_SIZE];
+    Move move;        /* The move that was played */
+    int captured;     /* Piece captured by the move (EMPTY if none) */
+    int castlePerm;   /* Castling rights before the move */
+    int enPas;        /* En passant square before the move */
+    int fiftyMove;    /* Fifty-move clock before the move */
+    int pliesFromNull; /* pliesFromNull before the move */
+    uint64_t posKey;  /* Zobrist key before the move */
+    uint64_t pawnKey; /* Pawn-only key before the move */
+    int psqtMg;       /* Evaluation totals before the move */
+    int psqtEg;
+    int phase;
+} Undo;
+
+/*
+   Board structure.
+   The position is kept twice: a square-indexed array for "what is on this
+   square" lookups, and bitboards for set-wise work (attacks, movegen, eval).
+   MakeMove/UnmakeMove keep both in sync.
+*/
+typedef struct Board {
+    int pieces[BOARD_SIZE];         /* Piece on each square (EMPTY if none) */
+    Bitboard pieceBB[13];           /* One bitboard per piece code (index 0 unused) */
+    Bitboard colorBB[3];            /* Occupancy for WHITE, BLACK and BOTH */
     int side;
     int enPas;
     int castlePerm;
+    int fiftyMove;                  /* Half-moves since the last capture or pawn move */
+    int pliesFromNull;              /* Half-moves since the last null move (or game start) */
+    int ply;                        /* Half-moves made since the search root */
+    uint64_t posKey;                /* Zobrist key, updated incrementally */
+    uint64_t pawnKey;               /* Zobrist key of the pawns only */
+    int psqtMg;                     /* Material + PST, middle game (white - black) */
+    int psqtEg;                     /* Material + PST, endgame (white - black) */
+    int phase;                      /* Game phase, PHASE_TOTAL with all pieces on */
+    Accumulator acc;                /* NNUE first layer, kept while NnueEnabled */
+    int hisPly;                     /* Number of entries in history[] */
+    Undo history[MAX_GAME_MOVES];   /* Undo stack, one entry per move played */
     // Add other fields as necessary
 } Board;
 
+/* Color of a piece code (BOTH for EMPTY) */
+static inline int PieceColor(int piece)
+{
+    if (piece >= W_PAWN && piece <= W_KING) return WHITE;
+    if (piece >= B_PAWN && piece <= B_KING) return BLACK;
+    return BOTH;
+}
+
+/* Colorless type of a non-empty piece code (PAWN..KING) */
+static inline int PieceType(int piece)
+{
+    return (piece > W_KING) ? piece - 6 : piece;
+}
+
+/* Piece code for a type and color, e.g. MakePiece(ROOK, BLACK) == B_ROOK */
+static inline int MakePiece(int type, int side)
+{
+    return (side == WHITE) ? type : type + 6;
+}
+
+/* Square of the given side's king */
+static inline int KingSquare(const Board* b, int side)
+{
+    return Lsb(b->pieceBB[MakePiece(KING, side)]);
+}
+
 /* Function prototypes */
+int  FRToSq(int file, int rank);
+int  CharToPiece(char c);
 void InitBoard(Board* b);
 void SetFen(Board* b, const char* fen, bool debugMode);
 bool IsMoveLegal(Board* b, Move move); /* Implement legality check */
-void MakeMove(Board* b, Move move);    /* Implement making a move */
+void MakeMove(Board* b, Move move);    /* Plays move, updating posKey incrementally */
+void UnmakeMove(Board* b);             /* Takes back the last move played */
+void MakeNullMove(Board* b);           /* Passes the turn (null-move pruning) */
+void UnmakeNullMove(Board* b);         /* Takes back MakeNullMove */
+
+#ifdef DEBUG
+bool CheckBoard(const Board* b);       /* Verifies bitboards, mailbox, keys and eval state agree */
+#endif
 
 #endif /* BOARD_H */
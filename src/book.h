@@ -0,0 +1,42 @@
+/****************************************************************************
+ * File: book.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the Polyglot (.bin) opening book.
+    - A book is a file of 16-byte entries sorted by position key:
+        uint64_t key     Polyglot hash of the position
+        uint16_t move    to file/rank, from file/rank, promotion (3 bits each)
+        uint16_t weight  relative frequency of the move
+        uint32_t learn   unused here
+      all big-endian. The file is memory-mapped and searched in place, so
+      opening a book costs nothing however large it is.
+    - Polyglot keys use their own fixed 781-entry random table, which is
+      built in (book.c); debug builds check it against the published key
+      of the start position when a book is opened.
+*/
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board.h"
+
+#define POLYGLOT_KEYS 781
+
+/* Map a book file, closing the previous one. An empty path closes the book. */
+bool BookOpen(const char* path);
+void BookClose(void);
+
+/* True while a book is open */
+bool BookReady(void);
+
+/* Polyglot key of a position */
+uint64_t PolyglotKey(const Board* b);
+
+/* A legal book move for the position, picked at random by weight, or
+   NOMOVE if the position isn't in the book */
+Move BookProbe(const Board* b);
+
+#endif /* BOOK_H */
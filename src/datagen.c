@@ -0,0 +1,346 @@
+/****************************************************************************
+ * File: datagen.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of self-play data generation.
+    - Each worker owns a Board, a SearchInfo and a small TransTable (cleared
+      per game) and plays whole games: DATAGEN random plies from the start
+      position, then one fixed-node SearchPosition per move. Games end by
+      the rules (mate, stalemate, fifty moves, threefold repetition,
+      insufficient material), by adjudication once one side has been
+      clearly winning for several plies, or at DATAGEN_MAX_PLIES as a draw.
+    - Positions are kept only if they are quiet (not in check, best move
+      not a capture or promotion) and the score isn't a mate score; they
+      are packed while the game runs and written once its result is known.
+    - Workers pick games from a shared counter and write under a lock;
+      the file is flushed at most every DATAGEN_FLUSH_MS.
+*/
+
+#include "datagen.h"
+#include "board.h"
+#include "bitboard.h"
+#include "movegen.h"
+#include "search.h"
+#include "transposition.h"
+#include "misc.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DATAGEN_MAX_PLIES     400
+#define DATAGEN_OPENING_LIMIT 1000 /* Replay openings scored beyond this ... */
+#define DATAGEN_OPENING_TRIES 100  /* ... at most this often, then skip the game */
+#define DATAGEN_WIN_SCORE     2000 /* Adjudicate a win above this score ... */
+#define DATAGEN_WIN_PLIES     6    /* ... held for this many plies in a row */
+#define DATAGEN_SCORE_LIMIT   10000 /* Mate and tablebase scores aren't kept */
+#define DATAGEN_FLUSH_MS      1000
+#define DATAGEN_REPORT_MS     10000
+
+/* Openings must leave room for a game, and a game must fit in Board.history */
+_Static_assert(DATAGEN_MAX_RANDOM * 2 <= DATAGEN_MAX_PLIES, "Random openings would crowd out the game");
+_Static_assert(DATAGEN_MAX_PLIES < MAX_GAME_MOVES, "A datagen game must fit in Board.history");
+
+#define START_FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+
+/* Settings, output and totals of one datagen run */
+typedef struct {
+    FILE* out;
+    pthread_mutex_t outLock;   /* Guards out and everything below it */
+    atomic_uint_fast64_t gamesClaimed;
+    uint64_t games;            /* Target */
+    uint64_t nodes;
+    int randomPlies;
+    uint64_t seed;
+    size_t ttEntries;
+    uint64_t gamesDone;
+    uint64_t gamesSkipped;     /* No usable opening found */
+    uint64_t positions;
+    int64_t startTime;
+    int64_t lastFlush;
+    int64_t lastReport;
+} DatagenShared;
+
+typedef struct {
+    uint64_t rng;
+    Board board;
+    SearchInfo info;
+    TransTable tt;
+    DatagenShared* shared;
+    uint8_t records[DATAGEN_MAX_PLIES][DATAGEN_RECORD_SIZE];
+    int side[DATAGEN_MAX_PLIES];     /* Side to move of each record */
+} DatagenWorker;
+
+/* xorshift64* per worker */
+static uint64_t NextRandom(DatagenWorker* w)
+{
+    w->rng ^= w->rng >> 12;
+    w->rng ^= w->rng << 25;
+    w->rng ^= w->rng >> 27;
+    return w->rng * 0x2545F4914F6CDD1DULL;
+}
+
+static void PutLE(uint8_t* p, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/* Packs b into out (the result byte is filled in when the game ends) */
+static void PackPosition(const Board* b, int score, int gamePly, uint8_t* out)
+{
+    memset(out, 0, DATAGEN_RECORD_SIZE);
+
+    Bitboard occupied = b->colorBB[BOTH];
+    PutLE(out, occupied, 8);
+
+    int n = 0;
+    Bitboard bb = occupied;
+    while (bb) {
+        int piece = b->pieces[PopLsb(&bb)];
+        out[8 + n / 2] |= (uint8_t)(piece << (4 * (n & 1)));
+        n++;
+    }
+
+    if (score > INT16_MAX) score = INT16_MAX;
+    if (score < INT16_MIN) score = INT16_MIN;
+    PutLE(out + 24, (uint16_t)(int16_t)score, 2);
+    out[27] = (uint8_t)((b->side == BLACK) | (b->castlePerm << 1));
+    out[28] = (uint8_t)b->enPas;
+    out[29] = (uint8_t)(b->fiftyMove > 255 ? 255 : b->fiftyMove);
+    PutLE(out + 30, (uint16_t)gamePly, 2);
+}
+
+/* Current position seen twice before since the last irreversible move */
+static bool IsThreefold(const Board* b)
+{
+    int first = b->hisPly - b->fiftyMove;
+    if (first < 0) first = 0;
+
+    int count = 0;
+    for (int i = b->hisPly - 2; i >= first; i -= 2) {
+        if (b->history[i].posKey == b->posKey && ++count == 2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* No pawns, rooks or queens, and at most one minor piece on the board */
+static bool IsInsufficientMaterial(const Board* b)
+{
+    Bitboard heavy = b->pieceBB[W_PAWN] | b->pieceBB[B_PAWN] | b->pieceBB[W_ROOK]
+                   | b->pieceBB[B_ROOK] | b->pieceBB[W_QUEEN] | b->pieceBB[B_QUEEN];
+    return !heavy && PopCount(b->colorBB[BOTH]) <= 3;
+}
+
+static bool InCheck(const Board* b)
+{
+    return IsSquareAttacked(b, KingSquare(b, b->side), b->side ^ 1);
+}
+
+/* One fixed-node search of the worker's board */
+static void SearchMove(DatagenWorker* w)
+{
+    ClearSearchInfo(&w->info);
+    w->info.nodeLimit = w->shared->nodes;
+    w->info.tt        = &w->tt;
+    w->info.report    = false;
+    SearchPosition(&w->board, &w->info);
+}
+
+/*
+    PlayRandomOpening:
+    - Random legal plies from the start position; false if the game ended
+      on the way or the result is already lopsided (the worker retries).
+*/
+static bool PlayRandomOpening(DatagenWorker* w)
+{
+    Move moves[MAX_POSITION_MOVES];
+
+    SetFen(&w->board, START_FEN, false);
+    for (int ply = 0; ply < w->shared->randomPlies; ply++) {
+        int count = GenerateLegalMoves(&w->board, moves);
+        if (count == 0) {
+            return false;
+        }
+        MakeMove(&w->board, moves[NextRandom(w) % count]);
+    }
+    if (GenerateLegalMoves(&w->board, moves) == 0) {
+        return false;
+    }
+
+    ClearTranspositionTable(&w->tt);
+    SearchMove(w);
+    return abs(w->info.bestScore) <= DATAGEN_OPENING_LIMIT;
+}
+
+/*
+    PlayGame:
+    - Plays one game and returns the number of packed records; the game
+      result is written into each record's result byte.
+    - Returns -1 without playing if DATAGEN_OPENING_TRIES random openings
+      all failed (e.g. --random-plies so high that most games are over).
+*/
+static int PlayGame(DatagenWorker* w)
+{
+    int tries = 0;
+    while (!PlayRandomOpening(w)) {
+        if (++tries == DATAGEN_OPENING_TRIES) {
+            return -1;
+        }
+    }
+
+    Board* b = &w->board;
+    Move moves[MAX_POSITION_MOVES];
+    int count = 0;
+    int whiteResult = 0;  /* +1 white won, 0 draw, -1 black won */
+    int winStreak = 0;    /* Plies in a row with a decisive score, signed for white */
+
+    for (int ply = w->shared->randomPlies; ply < DATAGEN_MAX_PLIES; ply++) {
+        if (GenerateLegalMoves(b, moves) == 0) {
+            whiteResult = InCheck(b) ? (b->side == WHITE ? -1 : 1) : 0;
+            break;
+        }
+        if (b->fiftyMove >= 100 || IsThreefold(b) || IsInsufficientMaterial(b)) {
+            break;
+        }
+
+        SearchMove(w);
+        Move best  = w->info.bestMove;
+        int score  = w->info.bestScore;
+        int whiteScore = (b->side == WHITE) ? score : -score;
+
+        if (whiteScore >= DATAGEN_WIN_SCORE) {
+            winStreak = (winStreak > 0) ? winStreak + 1 : 1;
+        }
+        else if (whiteScore <= -DATAGEN_WIN_SCORE) {
+            winStreak = (winStreak < 0) ? winStreak - 1 : -1;
+        }
+        else {
+            winStreak = 0;
+        }
+        if (abs(winStreak) >= DATAGEN_WIN_PLIES) {
+            whiteResult = (winStreak > 0) ? 1 : -1;
+            break;
+        }
+
+        if (!InCheck(b) && !IsCapture(best) && !IsPromotion(best)
+            && abs(score) < DATAGEN_SCORE_LIMIT) {
+            PackPosition(b, score, ply, w->records[count]);
+            w->side[count++] = b->side;
+        }
+        MakeMove(b, best);
+    }
+
+    for (int i = 0; i < count; i++) {
+        int result = (w->side[i] == WHITE) ? whiteResult : -whiteResult;
+        w->records[i][26] = (uint8_t)(result + 1);
+    }
+    return count;
+}
+
+static void* WorkerMain(void* arg)
+{
+    DatagenWorker* w = (DatagenWorker*)arg;
+    DatagenShared* shared = w->shared;
+
+    while (atomic_fetch_add(&shared->gamesClaimed, 1) < shared->games) {
+        int count = PlayGame(w);
+
+        pthread_mutex_lock(&shared->outLock);
+        if (count < 0) {
+            shared->gamesSkipped++;
+            count = 0;
+        }
+        fwrite(w->records, DATAGEN_RECORD_SIZE, (size_t)count, shared->out);
+        shared->gamesDone++;
+        shared->positions += (uint64_t)count;
+
+        int64_t now = GetTimeMs();
+        if (now - shared->lastFlush >= DATAGEN_FLUSH_MS) {
+            fflush(shared->out);
+            shared->lastFlush = now;
+        }
+        if (now - shared->lastReport >= DATAGEN_REPORT_MS) {
+            int64_t elapsed = now - shared->startTime;
+            fprintf(stderr, "Games: %llu/%llu  Positions: %llu  Positions/s: %.0f\n",
+                    (unsigned long long)shared->gamesDone, (unsigned long long)shared->games,
+                    (unsigned long long)shared->positions,
+                    elapsed > 0 ? shared->positions * 1000.0 / elapsed : 0.0);
+            shared->lastReport = now;
+        }
+        pthread_mutex_unlock(&shared->outLock);
+    }
+    return NULL;
+}
+
+/* Seeds worker index's generator from the run's seed and allocates its TT */
+static bool InitWorker(void* worker, int index, void* arg)
+{
+    DatagenWorker* w = (DatagenWorker*)worker;
+    DatagenShared* shared = (DatagenShared*)arg;
+
+    w->shared = shared;
+    w->rng    = (shared->seed + 1) * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(index + 1) * 0xD1B54A32D192ED03ULL;
+    if (!w->rng) w->rng = 1;
+    InitTranspositionTable(&w->tt, shared->ttEntries);
+    return w->tt.buckets != NULL;
+}
+
+static void ReleaseWorker(void* worker)
+{
+    FreeTranspositionTable(&((DatagenWorker*)worker)->tt);
+}
+
+/*
+    RunDatagen:
+    - Checks the options, opens the output, runs the workers until all
+      games are claimed and reports totals.
+*/
+bool RunDatagen(const DatagenOptions* opts)
+{
+    DatagenShared shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.games       = opts->games ? opts->games : DATAGEN_DEFAULT_GAMES;
+    shared.nodes       = opts->nodes ? opts->nodes : DATAGEN_DEFAULT_NODES;
+    shared.randomPlies = (opts->randomPlies >= 0) ? opts->randomPlies : DATAGEN_DEFAULT_RANDOM;
+    shared.seed        = opts->seed;
+    shared.ttEntries   = (opts->hashMb ? opts->hashMb : DATAGEN_DEFAULT_HASH_MB)
+                         * 1024 * 1024 / sizeof(TTEntry);
+    atomic_init(&shared.gamesClaimed, 0);
+
+    if (shared.randomPlies > DATAGEN_MAX_RANDOM) {
+        fprintf(stderr, "Error: --random-plies must be between 0 and %d\n", DATAGEN_MAX_RANDOM);
+        return false;
+    }
+
+    shared.out = fopen(opts->outPath, "ab");
+    if (!shared.out) {
+        fprintf(stderr, "Error: Unable to open %s\n", opts->outPath);
+        return false;
+    }
+    pthread_mutex_init(&shared.outLock, NULL);
+
+    static const WorkerPool pool = {
+        "datagen", sizeof(DatagenWorker), InitWorker, WorkerMain, ReleaseWorker
+    };
+    int threads = (opts->threads > MAX_THREADS) ? MAX_THREADS : opts->threads;
+    shared.startTime  = GetTimeMs();
+    shared.lastFlush  = shared.startTime;
+    shared.lastReport = shared.startTime;
+    int ran = RunWorkers(&pool, threads, &shared, &shared.startTime);
+    int64_t elapsed = GetTimeMs() - shared.startTime;
+
+    fprintf(stderr, "Games: %llu (%llu skipped)  Positions: %llu  Time: %lld ms  Positions/s: %.0f\n",
+            (unsigned long long)shared.gamesDone, (unsigned long long)shared.gamesSkipped,
+            (unsigned long long)shared.positions,
+            (long long)elapsed, elapsed > 0 ? shared.positions * 1000.0 / elapsed : 0.0);
+
+    pthread_mutex_destroy(&shared.outLock);
+    fclose(shared.out);
+    return ran > 0;
+}
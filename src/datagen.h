@@ -0,0 +1,61 @@
+/****************************************************************************
+ * File: datagen.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for self-play training data generation (./bear datagen).
+    - Worker threads play fixed-node games against themselves, each game
+      starting with a few random plies, and write the quiet positions of
+      every finished game with their search scores and the game result.
+    - Output is a stream of fixed-size PackedPosition records (no header,
+      so files can simply be concatenated), written a game at a time and
+      flushed periodically.
+
+    Record format (DATAGEN_RECORD_SIZE bytes, multi-byte fields little-endian):
+        offset  size  field
+         0       8    occupancy   bitboard of occupied squares (a1 = bit 0)
+         8      16    pieces      piece code (1..12, defs.h) of each occupied
+                                  square in occupancy order, two per byte,
+                                  low nibble first
+        24       2    score       int16 search score, side to move's view
+        26       1    result      0 = side to move lost, 1 = draw, 2 = won
+        27       1    flags       bit 0: black to move, bits 1-4: castling
+                                  rights (WKCA.. BQCA)
+        28       1    enPas       en passant square, 64 if none
+        29       1    fiftyMove   halfmove clock
+        30       2    gamePly     plies since the start of the game
+
+    Exports:
+      1) bool RunDatagen(const DatagenOptions* opts);
+*/
+
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DATAGEN_RECORD_SIZE 32
+
+#define DATAGEN_DEFAULT_GAMES   1000
+#define DATAGEN_DEFAULT_NODES   5000
+#define DATAGEN_DEFAULT_RANDOM  8    /* Random plies at the start of a game */
+#define DATAGEN_MAX_RANDOM      100  /* Most random plies accepted */
+#define DATAGEN_DEFAULT_HASH_MB 16   /* Per worker */
+
+typedef struct {
+    const char* outPath;   /* Output file (appended to) */
+    uint64_t games;        /* Games to play in total */
+    uint64_t nodes;        /* Node limit per move */
+    int randomPlies;
+    int threads;
+    size_t hashMb;
+    uint64_t seed;         /* Reproducible openings per worker */
+} DatagenOptions;
+
+/* Play the games; prints progress to stderr. False if the options are out of
+   range or the output can't be opened. */
+bool RunDatagen(const DatagenOptions* opts);
+
+#endif /* DATAGEN_H */
@@ -10,8 +10,11 @@
 
 #include <stdbool.h>
 
-/* Board size in mailbox representation (10x12) */
-#define BOARD_SIZE 120
+/* Number of squares (8x8, a1 = 0, b1 = 1, ... h8 = 63) */
+#define BOARD_SIZE 64
+
+/* "No square", e.g. when there is no en passant target */
+#define NO_SQ 64
 
 /* Piece codes */
 #define EMPTY 0
@@ -30,9 +33,18 @@
 #define B_QUEEN  11
 #define B_KING   12
 
+/* Piece types (colorless), as returned by PieceType() */
+#define PAWN   1
+#define KNIGHT 2
+#define BISHOP 3
+#define ROOK   4
+#define QUEEN  5
+#define KING   6
+
 /* Side to move */
 #define WHITE 0
 #define BLACK 1
+#define BOTH  2
 
 /* Castling flags */
 #define WKCA (1 << 0) /* White Kingside Castling Allowed */
@@ -40,8 +52,31 @@
 #define BKCA (1 << 2) /* Black Kingside Castling Allowed */
 #define BQCA (1 << 3) /* Black Queenside Castling Allowed */
 
-/* Evaluation constants */
-#define INFINITY 1000000
-#define MATE 999900
+/* Evaluation constants (must fit the 16-bit score stored in the TT) */
+#define INFINITY 32000
+#define MATE 31000
+
+/* Material values in centipawns */
+#define VAL_PAWN   100
+#define VAL_KNIGHT 320
+#define VAL_BISHOP 330
+#define VAL_ROOK   500
+#define VAL_QUEEN  900
+#define VAL_KING   20000
+
+/* Debug-build consistency checks (compiled away unless DEBUG is defined) */
+#ifdef DEBUG
+#include <stdio.h>
+#include <stdlib.h>
+#define ASSERT(n) \
+    do { \
+        if(!(n)) { \
+            fprintf(stderr, "Assertion failed: %s (%s:%d)\n", #n, __FILE__, __LINE__); \
+            abort(); \
+        } \
+    } while(0)
+#else
+#define ASSERT(n) ((void)0)
+#endif
 
 #endif /* DEFS_H */
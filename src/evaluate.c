@@ -4,24 +4,28 @@
 /*
    Description:
    - Implementation of classical evaluation heuristics.
-   - Compute material balance, plus optional minor heuristics.
-   - Possibly use piece-square tables for each piece type.
-   - Include bishop pair, rook on open files, king safety, etc.
+   - Material plus tapered (middle game / endgame) piece-square scores,
+     kept up to date by the board, plus minor heuristics.
+   - Pawn structure (cached in the pawn table), rooks on open files and the
+     bishop pair; king safety etc. are still to come.
 */
 
 #include "evaluate.h"
 #include "defs.h"  /* Not strictly necessary if board.h already includes defs.h,
                       but it's harmless to have it here for clarity. */
+#include "pawns.h"
+#include <stddef.h> /* For NULL */
 
-/* 
-   Example piece-square tables (PST) for White pieces.
-   ----------------------------------------------------
-   Typically indexed by 0..63 for each square on an 8x8 board, 
-   but we can access them by converting 120-based indices to 0-based 
-   rank/file if we prefer. 
+/*
+   Piece-square tables for White pieces.
+   -------------------------------------
+   Written as the board is seen from White's side: the first row is rank 8
+   and the last row is rank 1, so White looks a square up with sq ^ 56 and
+   Black (mirrored) with sq itself. Pieces without an endgame table use the
+   same table in both phases.
 */
 
-/* White Pawn PST */
+/* White Pawn PST (middle game) */
 static const int PawnPST[64] = {
       0,   0,   0,   0,   0,   0,   0,   0,
      50,  50,  50,  50,  50,  50,  50,  50,
@@ -81,7 +85,7 @@ static const int QueenPST[64] = {
     -20, -10, -10,  -5,  -5, -10, -10, -20
 };
 
-/* White King PST (middle-game oriented example) */
+/* White King PST (middle game: stay behind the pawns) */
 static const int KingPST[64] = {
     -30, -40, -40, -50, -50, -40, -40, -30,
     -30, -40, -40, -50, -50, -40, -40, -30,
@@ -93,119 +97,158 @@ static const int KingPST[64] = {
      20,  30,  10,   0,   0,  10,  30,  20
 };
 
-/* Converts a 120-based square index to 0..63 for PST lookups. */
-static int Sq120ToPSTIndex(int sq120)
-{
-    /* rank = (sq120 / 10) - 2, file = (sq120 % 10) - 1 */
-    int rank = (sq120 / 10) - 2;
-    int file = (sq120 % 10) - 1;
-    return (rank >= 0 && rank < 8 && file >= 0 && file < 8)
-         ? rank * 8 + file  /* 0..63 on-board */
-         : -1;              /* indicates off-board */
-}
+/* White Pawn PST (endgame: passed pawns become the main asset) */
+static const int PawnEndPST[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     80,  80,  80,  80,  80,  80,  80,  80,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     15,  15,  15,  15,  15,  15,  15,  15,
+      5,   5,   5,   5,   5,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+/* White King PST (endgame: head for the centre) */
+static const int KingEndPST[64] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50
+};
 
-/* Mirror a 0..63 index (for black PST lookups) so black uses the same table reversed. */
-static int Mirror64(int index)
+/* Mirror a 0..63 index: (7 - rank) * 8 + file */
+static inline int Mirror64(int index)
 {
-    int rank = index / 8;
-    int file = index % 8;
-    return (7 - rank) * 8 + file; 
+    return index ^ 56;
 }
 
+/* Material value and PSTs for each piece type, indexed PAWN..KING.
+   The king's value is left out: both sides always have one. */
+static const int PieceValue[7] = {
+    0, VAL_PAWN, VAL_KNIGHT, VAL_BISHOP, VAL_ROOK, VAL_QUEEN, 0
+};
+static const int* const MgTables[7] = {
+    NULL, PawnPST, KnightPST, BishopPST, RookPST, QueenPST, KingPST
+};
+static const int* const EgTables[7] = {
+    NULL, PawnEndPST, KnightPST, BishopPST, RookPST, QueenPST, KingEndPST
+};
+
+/* Rook on a file without own pawns: [0] semi-open, [1] fully open */
+static const int RookFileMg[2] = { 10, 20 };
+static const int RookFileEg[2] = {  5, 10 };
+
+int PsqtMg[13][BOARD_SIZE];
+int PsqtEg[13][BOARD_SIZE];
+
+const int PhaseWeight[13] = {
+    0,
+    0, 1, 1, 2, 4, 0, /* White */
+    0, 1, 1, 2, 4, 0  /* Black */
+};
+
 /*
-   EvaluatePosition:
-   - Basic loop for material + PST scoring.
-   - Minor heuristics like bishop pair.
+    InitEvaluation:
+    - Folds material into the PSTs and expands them to one signed entry
+      per piece code, so a board update is a single add per table.
 */
-int EvaluatePosition(const Board* b)
+void InitEvaluation(void)
 {
-    int score = 0;
-    int whiteBishops = 0;
-    int blackBishops = 0;
-
-    /* Scan the mailbox. */
-    for (int sq = 0; sq < BOARD_SIZE; sq++) {
-        int piece = b->pieces[sq];
-        if (piece == EMPTY) {
-            continue;
+    for (int type = PAWN; type <= KING; type++) {
+        int white = MakePiece(type, WHITE);
+        int black = MakePiece(type, BLACK);
+        for (int sq = 0; sq < BOARD_SIZE; sq++) {
+            PsqtMg[white][sq] =  PieceValue[type] + MgTables[type][Mirror64(sq)];
+            PsqtEg[white][sq] =  PieceValue[type] + EgTables[type][Mirror64(sq)];
+            PsqtMg[black][sq] = -PieceValue[type] - MgTables[type][sq];
+            PsqtEg[black][sq] = -PieceValue[type] - EgTables[type][sq];
         }
+    }
+}
 
-        int pstIndex = Sq120ToPSTIndex(sq);
-        /* If off-board, skip. */
-        if (pstIndex < 0 || pstIndex >= 64) {
-            continue;
+/*
+    ComputeEvalTotals:
+    - Full scan of the piece bitboards; only used when a board is set up
+      and by the debug consistency check.
+*/
+void ComputeEvalTotals(const Board* b, int* mg, int* eg, int* phase)
+{
+    *mg = *eg = *phase = 0;
+    for (int piece = W_PAWN; piece <= B_KING; piece++) {
+        Bitboard bb = b->pieceBB[piece];
+        *phase += PopCount(bb) * PhaseWeight[piece];
+        while (bb) {
+            int sq = PopLsb(&bb);
+            *mg += PsqtMg[piece][sq];
+            *eg += PsqtEg[piece][sq];
         }
+    }
+}
 
-        switch (piece) {
-            /* White Pieces */
-            case W_PAWN:
-                score += VAL_PAWN + PawnPST[pstIndex];
-                break;
-            case W_KNIGHT:
-                score += VAL_KNIGHT + KnightPST[pstIndex];
-                break;
-            case W_BISHOP:
-                score += VAL_BISHOP + BishopPST[pstIndex];
-                whiteBishops++;
-                break;
-            case W_ROOK:
-                score += VAL_ROOK + RookPST[pstIndex];
-                break;
-            case W_QUEEN:
-                score += VAL_QUEEN + QueenPST[pstIndex];
-                break;
-            case W_KING:
-                score += VAL_KING + KingPST[pstIndex];
-                break;
-
-            /* Black Pieces */
-            case B_PAWN:
-                score -= VAL_PAWN;
-                score -= PawnPST[Mirror64(pstIndex)];
-                break;
-            case B_KNIGHT:
-                score -= VAL_KNIGHT;
-                score -= KnightPST[Mirror64(pstIndex)];
-                break;
-            case B_BISHOP:
-                score -= VAL_BISHOP;
-                score -= BishopPST[Mirror64(pstIndex)];
-                blackBishops++;
-                break;
-            case B_ROOK:
-                score -= VAL_ROOK;
-                score -= RookPST[Mirror64(pstIndex)];
-                break;
-            case B_QUEEN:
-                score -= VAL_QUEEN;
-                score -= QueenPST[Mirror64(pstIndex)];
-                break;
-            case B_KING:
-                score -= VAL_KING;
-                score -= KingPST[Mirror64(pstIndex)];
-                break;
-
-            default:
-                /* Should not happen if piece codes are 0..12 only. */
-                break;
-        }
+/* Rook bonus of one side for files it has no pawns on, from the pawn entry */
+static void EvaluateRookFiles(const Board* b, const PawnEntry* pawns, int side,
+                              int* mg, int* eg)
+{
+    Bitboard rooks = b->pieceBB[MakePiece(ROOK, side)];
+    while (rooks) {
+        int file = FILE_OF(PopLsb(&rooks));
+        if (pawns->fileMask[side] & (1 << file)) continue;
+        int open = !(pawns->fileMask[side ^ 1] & (1 << file));
+        *mg += RookFileMg[open];
+        *eg += RookFileEg[open];
     }
+}
+
+/*
+   EvaluateClassical:
+   - Material + PST come straight from the board's running totals, and the
+     pawn-structure terms from the pawn table, so only a hash probe and a
+     few piece-wise terms are left per call.
+   - The middle game and endgame scores are blended by game phase.
+     (Promotions can push the phase above PHASE_TOTAL, hence the clamp.)
+   - Minor heuristics like bishop pair.
+*/
+static int EvaluateClassical(const Board* b)
+{
+    const PawnEntry* pawns = ProbePawnTable(b);
+    int mg = b->psqtMg + pawns->mg;
+    int eg = b->psqtEg + pawns->eg;
+
+    int wMg = 0, wEg = 0, bMg = 0, bEg = 0;
+    EvaluateRookFiles(b, pawns, WHITE, &wMg, &wEg);
+    EvaluateRookFiles(b, pawns, BLACK, &bMg, &bEg);
+    mg += wMg - bMg;
+    eg += wEg - bEg;
+
+    int phase = (b->phase < PHASE_TOTAL) ? b->phase : PHASE_TOTAL;
+    int score = (mg * phase + eg * (PHASE_TOTAL - phase)) / PHASE_TOTAL;
 
     /* Bishop pair bonus example. */
-    if (whiteBishops >= 2) {
+    if (PopCount(b->pieceBB[W_BISHOP]) >= 2) {
         score += 30;
     }
-    if (blackBishops >= 2) {
+    if (PopCount(b->pieceBB[B_BISHOP]) >= 2) {
         score -= 30;
     }
 
-    /* 
-       If you want to factor in side to move:
-         if (b->side == BLACK) {
-             score = -score;
-         }
-       That depends on your evaluation philosophy.
-    */
-
     return score;
 }
+
+/*
+   EvaluatePosition:
+   - Uses the NNUE when a net is loaded and enabled, the hand-written
+     evaluation otherwise.
+*/
+int EvaluatePosition(const Board* b)
+{
+    if (NnueEnabled) {
+        int score = NnueEvaluate(b);
+        return (b->side == WHITE) ? score : -score;
+    }
+    return EvaluateClassical(b);
+}
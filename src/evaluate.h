@@ -1,11 +1,37 @@
 /****************************************************************************
  * File: evaluate.h
  ****************************************************************************/
+/*
+    Description:
+    - Header for the evaluation.
+    - Material and piece-square scores are kept as running totals in the
+      Board: every piece added to or removed from a square adds or removes
+      its entry in PsqtMg/PsqtEg and its PhaseWeight, so EvaluatePosition
+      only has to blend the two totals by game phase.
+*/
+
 #ifndef EVALUATE_H
 #define EVALUATE_H
 
 #include "board.h"
 
+/* Game phase of the starting position (knight/bishop 1, rook 2, queen 4) */
+#define PHASE_TOTAL 24
+
+/* Material + PST score per [piece][square], white positive, filled by InitEvaluation() */
+extern int PsqtMg[13][BOARD_SIZE];
+extern int PsqtEg[13][BOARD_SIZE];
+
+/* Phase contribution of each piece code */
+extern const int PhaseWeight[13];
+
+/* Build the combined tables. Must be called once before any board is set up. */
+void InitEvaluation(void);
+
+/* Compute the board's psqtMg, psqtEg and phase totals from scratch. */
+void ComputeEvalTotals(const Board* b, int* mg, int* eg, int* phase);
+
+/* Static evaluation from white's point of view (NNUE or classical) */
 int EvaluatePosition(const Board* b);
 
 #endif /* EVALUATE_H */
@@ -4,15 +4,43 @@
 /*
     Implementation of the centralized logging functionality.
     Controls what messages are printed based on the current log level and debug mode.
+
+    With a log file set, LogMessage never touches the file itself: the
+    formatted line is copied into a bounded lock-free ring buffer (one
+    sequence number per slot, so any number of threads can log at once)
+    and a writer thread drains it. If the ring is full the line is dropped
+    and counted, so a slow disk can never stall the search.
 */
 
 #include "log.h"
+#include "misc.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <string.h>
 
+#define LOG_LINE_SIZE   256  /* Longer lines are truncated */
+#define LOG_RING_SLOTS  1024 /* Power of two */
+#define LOG_WRITER_MS   5    /* Writer sleep when the ring is empty */
+
 /* Static variables to hold logging state */
 static bool isDebug = false;
 static LogLevel currentLevel = LOG_INFO;
-static FILE* logFile = NULL; /* Optional: can be extended to log to files */
+static FILE* logFile = NULL; /* Written by the writer thread only */
+
+/* One queued line; seq tells producers and the writer whose turn it is */
+typedef struct {
+    atomic_size_t seq;
+    char text[LOG_LINE_SIZE];
+} LogSlot;
+
+static LogSlot Ring[LOG_RING_SLOTS];
+static atomic_size_t RingTail;   /* Next slot to claim (any thread) */
+static size_t RingHead;          /* Next slot to write (writer thread) */
+static atomic_size_t Dropped;    /* Lines lost to a full ring */
+static atomic_bool WriterStop;
+static atomic_bool AsyncActive;  /* True while the writer thread runs */
+static pthread_t Writer;
 
 /*
     InitLogging:
@@ -32,46 +60,180 @@ void SetLogLevel(LogLevel level)
     currentLevel = level;
 }
 
+/* Queue a line for the writer; false if the ring is full */
+static bool RingPush(const char* text)
+{
+    size_t pos = atomic_load_explicit(&RingTail, memory_order_relaxed);
+
+    while (true) {
+        LogSlot* slot = &Ring[pos & (LOG_RING_SLOTS - 1)];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&RingTail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                size_t len = strlen(text);
+                if (len >= LOG_LINE_SIZE) len = LOG_LINE_SIZE - 1;
+                memcpy(slot->text, text, len);
+                slot->text[len] = '\0';
+                atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+                return true;
+            }
+            /* Lost the race for this slot: pos now holds the new tail */
+        }
+        else if (diff < 0) {
+            return false; /* The writer hasn't freed this slot yet */
+        }
+        else {
+            pos = atomic_load_explicit(&RingTail, memory_order_relaxed);
+        }
+    }
+}
+
+/* Take the next queued line (writer thread only); false if none */
+static bool RingPop(char* out)
+{
+    LogSlot* slot = &Ring[RingHead & (LOG_RING_SLOTS - 1)];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != RingHead + 1) {
+        return false;
+    }
+
+    memcpy(out, slot->text, LOG_LINE_SIZE);
+    atomic_store_explicit(&slot->seq, RingHead + LOG_RING_SLOTS, memory_order_release);
+    RingHead++;
+    return true;
+}
+
+/*
+    WriterMain:
+    - Drains the ring into logFile, flushing after each batch. The stop
+      flag is read before draining, so the last batch is always written.
+*/
+static void* WriterMain(void* arg)
+{
+    (void)arg;
+    char line[LOG_LINE_SIZE];
+
+    while (true) {
+        bool stop = atomic_load(&WriterStop);
+        bool wrote = false;
+
+        while (RingPop(line)) {
+            fputs(line, logFile);
+            wrote = true;
+        }
+        size_t dropped = atomic_exchange(&Dropped, 0);
+        if (dropped) {
+            fprintf(logFile, "[WARN] %zu log lines dropped (ring buffer full)\n", dropped);
+            wrote = true;
+        }
+        if (wrote) {
+            fflush(logFile);
+        }
+
+        if (stop) break;
+        SleepMs(LOG_WRITER_MS);
+    }
+    return NULL;
+}
+
+/*
+    CloseLogging:
+    - Stops the writer after it has written everything queued, then
+      closes the file. Output goes back to stdout.
+*/
+void CloseLogging(void)
+{
+    if (atomic_load(&AsyncActive)) {
+        atomic_store(&AsyncActive, false);
+        atomic_store(&WriterStop, true);
+        pthread_join(Writer, NULL);
+    }
+    if (logFile) {
+        fclose(logFile);
+        logFile = NULL;
+    }
+}
+
+/*
+    SetLogFile:
+    - Must not race with other threads logging (it is called between
+      searches). Falls back to writing the file directly if the writer
+      thread can't be started.
+*/
+bool SetLogFile(const char* path)
+{
+    CloseLogging();
+    if (!path || !path[0]) {
+        return true;
+    }
+
+    logFile = fopen(path, "a");
+    if (!logFile) {
+        return false;
+    }
+    if (currentLevel > LOG_INFO) {
+        currentLevel = LOG_INFO;
+    }
+
+    for (size_t i = 0; i < LOG_RING_SLOTS; i++) {
+        atomic_store_explicit(&Ring[i].seq, i, memory_order_relaxed);
+    }
+    atomic_store(&RingTail, 0);
+    RingHead = 0;
+    atomic_store(&Dropped, 0);
+    atomic_store(&WriterStop, false);
+
+    if (pthread_create(&Writer, NULL, WriterMain, NULL) == 0) {
+        atomic_store(&AsyncActive, true);
+    }
+    return true;
+}
+
 /*
     LogMessage:
     - Logs a message with the specified logging level.
-    - Only logs messages that are at or above the current logging level.
+    - Only logs messages that are at or above the current logging level;
+      both filters run before any formatting work.
 */
 void LogMessage(LogLevel level, const char* format, ...)
 {
     if(level < currentLevel) return;
-
-    va_list args;
-    va_start(args, format);
+    if(level <= LOG_DEBUG && !isDebug) return; /* Only log TRACE/DEBUG if debug is enabled */
 
     /* Prepare the message prefix */
-    char buffer[1024] = {0};
+    char buffer[LOG_LINE_SIZE];
+    const char* prefix = "";
     switch(level) {
-        case LOG_INFO:
-            strcat(buffer, "[INFO] ");
-            break;
-        case LOG_DEBUG:
-            if(!isDebug) return; /* Only log DEBUG if debug is enabled */
-            strcat(buffer, "[DEBUG] ");
-            break;
-        case LOG_WARN:
-            strcat(buffer, "[WARN] ");
-            break;
-        case LOG_ERROR:
-            strcat(buffer, "[ERROR] ");
-            break;
+        case LOG_TRACE: prefix = "[TRACE] "; break;
+        case LOG_DEBUG: prefix = "[DEBUG] "; break;
+        case LOG_INFO:  prefix = "[INFO] ";  break;
+        case LOG_WARN:  prefix = "[WARN] ";  break;
+        case LOG_ERROR: prefix = "[ERROR] "; break;
     }
+    size_t len = strlen(prefix);
+    memcpy(buffer, prefix, len + 1);
 
     /* Append the formatted message */
-    vsnprintf(buffer + strlen(buffer), sizeof(buffer) - strlen(buffer), format, args);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer + len, sizeof(buffer) - len, format, args);
+    va_end(args);
 
-    /* Output to logFile or stdout */
-    if(logFile) {
+    /* Queue for the log file writer, or write directly */
+    if(atomic_load_explicit(&AsyncActive, memory_order_acquire)) {
+        if(!RingPush(buffer)) {
+            atomic_fetch_add_explicit(&Dropped, 1, memory_order_relaxed);
+        }
+    }
+    else if(logFile) {
         fprintf(logFile, "%s", buffer);
         fflush(logFile);
-    } else {
+    }
+    else {
         printf("%s", buffer);
     }
-
-    va_end(args);
 }
@@ -5,6 +5,12 @@
     Description:
     - Header for centralized logging functionality.
     - Provides functions to initialize logging, set log levels, and log messages.
+    - Messages are logged through the LogTrace/LogDebug/LogInfo/LogWarn/LogError
+      macros. Levels below LOG_COMPILE_LEVEL compile to nothing, so logging
+      on hot paths (MakeMove, ...) costs nothing in release builds.
+    - Output goes to stdout, or to a log file through an asynchronous sink:
+      callers only copy the line into a lock-free ring buffer and a
+      background thread writes it out.
 */
 
 #ifndef LOG_H
@@ -14,21 +20,70 @@
 #include <stdarg.h>
 #include <stdbool.h>
 
-/* Logging levels */
+/* Level numbers, usable in #if */
+#define LOG_LEVEL_TRACE 0 /* Hot-path detail, only compiled into debug builds */
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+
+/* Logging levels, from most to least verbose */
 typedef enum {
-    LOG_INFO,
-    LOG_DEBUG,
-    LOG_WARN,
-    LOG_ERROR
+    LOG_TRACE = LOG_LEVEL_TRACE,
+    LOG_DEBUG = LOG_LEVEL_DEBUG,
+    LOG_INFO  = LOG_LEVEL_INFO,
+    LOG_WARN  = LOG_LEVEL_WARN,
+    LOG_ERROR = LOG_LEVEL_ERROR
 } LogLevel;
 
-/* Initialize logging with debug mode */
+/* Lowest level compiled in; override with -DLOG_COMPILE_LEVEL=<n> */
+#ifndef LOG_COMPILE_LEVEL
+#ifdef DEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_TRACE
+#define LogTrace(...) LogMessage(LOG_TRACE, __VA_ARGS__)
+#else
+#define LogTrace(...) ((void)0)
+#endif
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LogDebug(...) LogMessage(LOG_DEBUG, __VA_ARGS__)
+#else
+#define LogDebug(...) ((void)0)
+#endif
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LogInfo(...)  LogMessage(LOG_INFO, __VA_ARGS__)
+#else
+#define LogInfo(...)  ((void)0)
+#endif
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARN
+#define LogWarn(...)  LogMessage(LOG_WARN, __VA_ARGS__)
+#else
+#define LogWarn(...)  ((void)0)
+#endif
+#define LogError(...) LogMessage(LOG_ERROR, __VA_ARGS__)
+
+/* Initialize logging with debug mode (TRACE and DEBUG need debug mode) */
 void InitLogging(bool debug);
 
 /* Set the current logging level */
 void SetLogLevel(LogLevel level);
 
-/* Logging function with level */
+/*
+   Send log output to the file at path (appending), written by a background
+   thread. An empty path goes back to stdout. Returns false if the file
+   can't be opened. Lowers the level to LOG_INFO if it was above it.
+*/
+bool SetLogFile(const char* path);
+
+/* Write out anything still queued and close the log file */
+void CloseLogging(void);
+
+/* Logging function with level; prefer the macros above */
 void LogMessage(LogLevel level, const char* format, ...);
 
 #endif /* LOG_H */
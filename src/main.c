@@ -17,6 +17,12 @@
 #include "evaluate.h"
 #include "transposition.h"
 #include "uci.h"
+#include "zobrist.h"
+#include "bitboard.h"
+#include "perft.h"
+#include "analyze.h"
+#include "bench.h"
+#include "datagen.h"
 #include "log.h" /* Include logging header */
 
 int main(int argc, char* argv[])
@@ -25,7 +31,122 @@ int main(int argc, char* argv[])
     printf("Author: ChatGPT o1\n\n");
 
     int debugMode = 0; // Initialize debugMode
-    size_t ttSize = 1024 * 1024; /* Example: number of TT entries */
+    const char* logPath = NULL; /* --log-file: log through the async file sink */
+    const char* hashPath = NULL; /* --load-hash: start from a saved hash table */
+    size_t ttSize = (size_t)TT_DEFAULT_MB * 1024 * 1024 / sizeof(TTEntry); /* Number of TT entries */
+
+    /*
+       Perft mode:
+         ./bear perft                 - run the built-in perft suite
+         ./bear perft <depth> [fen]   - perft of the start position (or fen)
+       Exits with a non-zero status if a suite count does not match.
+    */
+    if(argc > 1 && !strcmp(argv[1], "perft")) {
+        InitLogging(false);
+        SetLogLevel(LOG_WARN);
+        InitBitboards();
+        InitZobrist();
+        InitEvaluation();
+
+        if(argc == 2) {
+            return RunPerftSuite() ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+
+        static Board perftBoard;
+        InitBoard(&perftBoard);
+        if(argc > 3) {
+            char fen[256] = {0};
+            for(int i = 3; i < argc; i++) {
+                strncat(fen, argv[i], sizeof(fen) - strlen(fen) - 2);
+                strcat(fen, " ");
+            }
+            SetFen(&perftBoard, fen, false);
+        }
+        PerftCommand(&perftBoard, atoi(argv[2]), false);
+        return EXIT_SUCCESS;
+    }
+
+    /*
+       Benchmark mode:
+         ./bear bench [depth] [threads] [hashMB]
+       Searches the built-in bench positions and prints nodes, time and NPS.
+    */
+    if(argc > 1 && !strcmp(argv[1], "bench")) {
+        InitLogging(false);
+        SetLogLevel(LOG_WARN);
+        InitBitboards();
+        InitZobrist();
+        InitEvaluation();
+        InitSearch();
+
+        RunBench(argc > 2 ? atoi(argv[2]) : 0, argc > 3 ? atoi(argv[3]) : 0,
+                 argc > 4 ? (size_t)atoi(argv[4]) : 0);
+        return EXIT_SUCCESS;
+    }
+
+    /*
+       Training data mode:
+         ./bear datagen --out <file> [--games N] [--nodes N] [--random-plies R]
+                        [--threads T] [--hash MB] [--seed S]
+       Plays N self-play games at N nodes per move and appends the packed
+       positions to the file (format in datagen.h).
+    */
+    if(argc > 1 && !strcmp(argv[1], "datagen")) {
+        InitLogging(false);
+        SetLogLevel(LOG_WARN);
+        InitBitboards();
+        InitZobrist();
+        InitEvaluation();
+        InitSearch();
+
+        DatagenOptions opts = { NULL, DATAGEN_DEFAULT_GAMES, DATAGEN_DEFAULT_NODES,
+                                DATAGEN_DEFAULT_RANDOM, 1, DATAGEN_DEFAULT_HASH_MB, 0 };
+        for(int i = 2; i + 1 < argc; i += 2) {
+            if(!strcmp(argv[i], "--out"))               opts.outPath     = argv[i + 1];
+            else if(!strcmp(argv[i], "--games"))        opts.games       = strtoull(argv[i + 1], NULL, 10);
+            else if(!strcmp(argv[i], "--nodes"))        opts.nodes       = strtoull(argv[i + 1], NULL, 10);
+            else if(!strcmp(argv[i], "--random-plies")) opts.randomPlies = atoi(argv[i + 1]);
+            else if(!strcmp(argv[i], "--threads"))      opts.threads     = atoi(argv[i + 1]);
+            else if(!strcmp(argv[i], "--hash"))         opts.hashMb      = (size_t)atoi(argv[i + 1]);
+            else if(!strcmp(argv[i], "--seed"))         opts.seed        = strtoull(argv[i + 1], NULL, 10);
+        }
+        if(!opts.outPath) {
+            fprintf(stderr, "Usage: %s datagen --out <file> [--games N] [--nodes N] [--random-plies R]"
+                            " [--threads T] [--hash MB] [--seed S]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        return RunDatagen(&opts) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /*
+       Batch analysis mode:
+         ./bear analyze --epd <file> [--depth N] [--threads T] [--hash MB] [--out <file>]
+       Searches every position of the file to depth N with T workers, each
+       with its own MB-sized hash table, and writes one EPD line per result.
+    */
+    if(argc > 1 && !strcmp(argv[1], "analyze")) {
+        InitLogging(false);
+        SetLogLevel(LOG_WARN);
+        InitBitboards();
+        InitZobrist();
+        InitEvaluation();
+        InitSearch();
+
+        AnalyzeOptions opts = { NULL, NULL, ANALYZE_DEFAULT_DEPTH, 1, ANALYZE_DEFAULT_HASH_MB };
+        for(int i = 2; i + 1 < argc; i += 2) {
+            if(!strcmp(argv[i], "--epd"))          opts.epdPath = argv[i + 1];
+            else if(!strcmp(argv[i], "--out"))     opts.outPath = argv[i + 1];
+            else if(!strcmp(argv[i], "--depth"))   opts.depth   = atoi(argv[i + 1]);
+            else if(!strcmp(argv[i], "--threads")) opts.threads = atoi(argv[i + 1]);
+            else if(!strcmp(argv[i], "--hash"))    opts.hashMb  = (size_t)atoi(argv[i + 1]);
+        }
+        if(!opts.epdPath) {
+            fprintf(stderr, "Usage: %s analyze --epd <file> [--depth N] [--threads T] [--hash MB] [--out <file>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        if(opts.hashMb < 1) opts.hashMb = 1;
+        return RunEpdAnalysis(&opts) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
     /* Process command-line arguments */
     for(int i = 1; i < argc; ++i) {
@@ -37,33 +158,66 @@ int main(int argc, char* argv[])
             ttSize = (size_t)atoi(argv[++i]);
             printf("Requested TT size: %zu entries\n", ttSize);
         }
+        else if(!strcmp(argv[i], "--log-file") && i + 1 < argc) {
+            logPath = argv[++i];
+            printf("Logging to: %s\n", logPath);
+        }
+        else if(!strcmp(argv[i], "--load-hash") && i + 1 < argc) {
+            hashPath = argv[++i];
+            printf("Hash snapshot: %s\n", hashPath);
+        }
+        else if(!strcmp(argv[i], "--hash") && i + 1 < argc) {
+            size_t megabytes = (size_t)atoi(argv[++i]);
+            ttSize = megabytes * 1024 * 1024 / sizeof(TTEntry);
+            printf("Requested TT size: %zu MB\n", megabytes);
+        }
     }
 
     /* Initialize logging */
     InitLogging(debugMode);
-    SetLogLevel(LOG_DEBUG); /* Set desired log level */
+    /* Protocol traffic shares stdout: only warnings and errors unless debugging */
+    SetLogLevel(debugMode ? LOG_TRACE : LOG_WARN);
+    if(logPath && !SetLogFile(logPath)) {
+        fprintf(stderr, "Error: Unable to open log file %s\n", logPath);
+    }
 
     /* Initialize engine components */
+    InitBitboards();
+    InitZobrist();
+    InitEvaluation();
+    InitSearch();
+
     Board board;
     InitBoard(&board);
-    LogMessage(LOG_DEBUG, "Board initialized.\n");
+    LogDebug("Board initialized.\n");
 
     TransTable tt;
     InitTranspositionTable(&tt, ttSize);
-    LogMessage(LOG_DEBUG, "Transposition Table initialized with %zu entries.\n", ttSize);
+    LogDebug("Transposition Table initialized with %zu entries.\n", ttSize);
+
+    /* The snapshot decides the table size; on failure the fresh table stays */
+    if(hashPath) {
+        if(LoadTranspositionTable(&tt, hashPath)) {
+            printf("Loaded %zu MB of hash from %s\n", tt.numEntries * sizeof(TTEntry) / (1024 * 1024), hashPath);
+        }
+        else {
+            fprintf(stderr, "Error: Unable to load the hash snapshot %s, starting empty\n", hashPath);
+        }
+    }
 
     /* Optionally set up the board with a FEN or start position */
     // SetFen(&board, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", true);
 
     /* Enter UCI loop */
-    LogMessage(LOG_DEBUG, "Entering UCI loop...\n");
+    LogDebug("Entering UCI loop...\n");
     UciLoop(&board, &tt);
-    LogMessage(LOG_DEBUG, "Exited UCI loop.\n");
+    LogDebug("Exited UCI loop.\n");
 
     /* Clean up before exit */
     FreeTranspositionTable(&tt);
-    LogMessage(LOG_DEBUG, "Transposition Table freed.\n");
+    LogDebug("Transposition Table freed.\n");
 
     printf("Engine exiting.\n");
+    CloseLogging();
     return 0;
 }
@@ -0,0 +1,120 @@
+/****************************************************************************
+ * File: misc.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of small platform helpers.
+*/
+
+#include "misc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/*
+    GetTimeMs:
+    - Returns a monotonic timestamp in milliseconds, suitable for
+      measuring elapsed time (not tied to the calendar clock).
+*/
+int64_t GetTimeMs(void)
+{
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+/*
+    SleepMs:
+    - Sleeps the calling thread; used for short waits while polling
+      a flag set by another thread.
+*/
+void SleepMs(int ms)
+{
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts;
+    ts.tv_sec  = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/*
+    CpuCount:
+    - Logical processors online, used to size work split over threads.
+*/
+int CpuCount(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (si.dwNumberOfProcessors > 0) ? (int)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+#endif
+}
+
+/*
+    RunWorkers:
+    - Workers are set up in order until one fails, and the pool then runs
+      with those that succeeded. A thread that can't be created just
+      leaves its worker idle; the others take its share of the work.
+*/
+int RunWorkers(const WorkerPool* pool, int threads, void* arg, int64_t* startTime)
+{
+    if (threads < 1) threads = 1;
+
+    char* workers      = (char*)malloc((size_t)threads * pool->size);
+    pthread_t* handles = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    if (!workers || !handles) {
+        fprintf(stderr, "Error: Unable to allocate %s workers\n", pool->name);
+        free(workers);
+        free(handles);
+        return 0;
+    }
+
+    int started = 0;
+    while (started < threads && pool->init(workers + started * pool->size, started, arg)) {
+        started++;
+    }
+    if (started < threads) {
+        fprintf(stderr, "Error: Memory for only %d of %d %s workers\n", started, threads, pool->name);
+    }
+
+    if (startTime) {
+        *startTime = GetTimeMs();
+    }
+    int running = 1;
+    for (int i = 1; i < started; i++) {
+        if (pthread_create(&handles[i], NULL, pool->run, workers + i * pool->size) != 0) {
+            break;
+        }
+        running++;
+    }
+    if (started > 0) {
+        pool->run(workers);
+    }
+    for (int i = 1; i < running; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    for (int i = 0; i < started; i++) {
+        pool->release(workers + i * pool->size);
+    }
+    free(handles);
+    free(workers);
+    return started;
+}
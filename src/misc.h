@@ -0,0 +1,56 @@
+/****************************************************************************
+ * File: misc.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for small platform helpers shared across the engine.
+*/
+
+#ifndef MISC_H
+#define MISC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> /* For _mm_prefetch */
+#endif
+
+/* Monotonic wall-clock time in milliseconds */
+int64_t GetTimeMs(void);
+
+/* Suspends the calling thread for about ms milliseconds */
+void SleepMs(int ms);
+
+/* Number of logical CPUs available (at least 1) */
+int CpuCount(void);
+
+/* A pool of identical worker threads, run by RunWorkers */
+typedef struct {
+    const char* name;                                 /* For error messages */
+    size_t size;                                      /* Bytes per worker */
+    bool (*init)(void* worker, int index, void* arg); /* False when out of memory */
+    void* (*run)(void* worker);                       /* Thread body */
+    void (*release)(void* worker);                    /* Undoes a successful init */
+} WorkerPool;
+
+/*
+   Sets up to threads workers, runs them to completion (the calling thread
+   runs the first) and releases them. *startTime, if given, is set just
+   before the threads start. Returns the number of workers that ran.
+*/
+int RunWorkers(const WorkerPool* pool, int threads, void* arg, int64_t* startTime);
+
+/* Hint the CPU to start loading the cache line at addr (no effect on results) */
+static inline void Prefetch(const void* addr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)addr, _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
+
+#endif /* MISC_H */
@@ -3,30 +3,71 @@
  ****************************************************************************/
 /*
     Description:
-    - Header defining the Move structure used across the engine.
+    - Header defining the Move type used across the engine.
     - Ensures that any file needing to use Move can include this header
       without introducing circular dependencies.
+
+    Encoding (16 bits):
+      bits  0-5   from square (0..63, a1 = 0)
+      bits  6-11  to square   (0..63, a1 = 0)
+      bits 12-15  flags: 4 = capture, 8 = promotion; with promotion the low
+                  two bits give the piece (knight, bishop, rook, queen),
+                  otherwise they mark double pushes, castling and en passant.
+    - The captured piece is not stored in the move; MakeMove keeps it in
+      the undo entry instead.
 */
 
 #ifndef MOVE_H
 #define MOVE_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "defs.h" /* For piece types */
+
+/* A packed move (see encoding above). NOMOVE is a1a1, never a real move. */
+typedef uint16_t Move;
+
+#define NOMOVE ((Move)0)
+
+/* Move flags (bits 12-15) */
+#define MFLAG_QUIET        0x0
+#define MFLAG_PAWNSTART    0x1 /* Pawn double push */
+#define MFLAG_KING_CASTLE  0x2 /* Short castling (the king's move is stored) */
+#define MFLAG_QUEEN_CASTLE 0x3 /* Long castling */
+#define MFLAG_CAPTURE      0x4
+#define MFLAG_EP           0x5 /* En passant capture */
+#define MFLAG_PROMO        0x8 /* Promotion; low 2 bits = piece type - KNIGHT */
+
+/* Build a move from its squares and flags */
+static inline Move EncodeMove(int from, int to, int flags)
+{
+    return (Move)(from | (to << 6) | (flags << 12));
+}
+
+static inline int FromSq(Move m)    { return m & 0x3F; }
+static inline int ToSq(Move m)      { return (m >> 6) & 0x3F; }
+static inline int MoveFlags(Move m) { return m >> 12; }
+
+static inline bool IsCapture(Move m)   { return (MoveFlags(m) & MFLAG_CAPTURE) != 0; }
+static inline bool IsPromotion(Move m) { return (MoveFlags(m) & MFLAG_PROMO) != 0; }
+static inline bool IsEnPassant(Move m) { return MoveFlags(m) == MFLAG_EP; }
+static inline bool IsPawnStart(Move m) { return MoveFlags(m) == MFLAG_PAWNSTART; }
+static inline bool IsCastle(Move m)
+{
+    return MoveFlags(m) == MFLAG_KING_CASTLE || MoveFlags(m) == MFLAG_QUEEN_CASTLE;
+}
 
-/* Define the Move structure */
-typedef struct {
-    int from;       /* The source square (120-based indexing) */
-    int to;         /* The target square (120-based indexing) */
-    int captured;   /* Piece type captured, if any (EMPTY if none) */
-    int promoted;   /* Piece type if this move is a promotion (EMPTY if none) */
-    int flag;       /* Bitmask for special move attributes (e.g., en passant, castling, promotion) */
-} Move;
+/* Colorless promotion piece type (KNIGHT..QUEEN); only valid if IsPromotion */
+static inline int PromotedType(Move m)
+{
+    return KNIGHT + (MoveFlags(m) & 0x3);
+}
 
 /* Forward declaration of Board struct */
 struct Board;
 
 /* Function prototypes related to Move conversions */
-Move UciMoveToMove(struct Board* board, const char* uci); /* Converts UCI move string to Move struct */
-void MoveToUciMove(Move move, char* uci);          /* Converts Move struct to UCI move string */
+Move UciMoveToMove(struct Board* board, const char* uci); /* Converts UCI move string to Move (NOMOVE if malformed) */
+void MoveToUciMove(Move move, char* uci);          /* Converts Move to UCI move string */
 
 #endif /* MOVE_H */
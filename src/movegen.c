@@ -8,46 +8,45 @@
      queens, kings, including special moves (castling, en passant, promotions).
    - Can return only captures via GenerateCaptures().
    - IsSquareAttacked checks if a given square is attacked by a specified side.
+   - Pieces are found by popping bits off the board's bitboards, and
+     targets come from the attack tables in bitboard.c.
+   - GenerateLegalMoves emits only legal moves: checkers and pinned pieces
+     are found once per position, then every piece's targets are masked
+     with the check and pin rays, so no make/unmake test is needed.
 
    Notes:
-   - Full legality checks (king not in check after move) are typically done
-     in MakeMove/UndoMove or a separate legality filter.
+   - GenerateAllMoves/GenerateCaptures stay pseudo-legal; callers of those
+     must reject moves that leave the king in check themselves.
 */
 
 #include "movegen.h"   /* For Move struct and prototypes */
 #include "defs.h"      /* For piece codes, BOARD_SIZE, etc. */
 #include <stddef.h>    /* For NULL if needed */
 
-/* Offsets for piece movement */
-static const int KnightOffsets[8] = { -21, -19, -12, -8, 8, 12, 19, 21 };
-static const int KingOffsets[8]   = { -9, -11,  9, 11, -10, 10, -1, 1 };
-static const int RookOffsets[4]   = { -10, 10, -1, 1 };
-static const int BishopOffsets[4] = { -9, -11,  9, 11 };
-
-/* Quickly check if a mailbox index is on the board [0..BOARD_SIZE-1] */
-static inline bool IsOnBoard(int sq) {
-    return (sq >= 0 && sq < BOARD_SIZE);
+/* Helper to store a newly generated move into moveList */
+static inline void AddMove(
+    int from, int to, int flags,
+    Move* moveList, int* moveCount
+) {
+    moveList[(*moveCount)++] = EncodeMove(from, to, flags);
 }
 
-/* Determine piece color by its code (returns WHITE, BLACK, or BOTH if EMPTY) */
-static inline int PieceColor(int piece) {
-    if (piece >= W_PAWN && piece <= W_KING)  return WHITE;
-    if (piece >= B_PAWN && piece <= B_KING)  return BLACK;
-    return BOTH; /* e.g. EMPTY */
+/* Flags for a plain move to 'to': a capture if an enemy piece stands there */
+static inline int CaptureFlag(const Board* b, int to)
+{
+    return (b->pieces[to] != EMPTY) ? MFLAG_CAPTURE : MFLAG_QUIET;
 }
 
-/* Helper to store a newly generated move into moveList */
-static inline void AddMove(
-    int from, int to, int captured, int promoted, int flag,
+/* Adds the four promotion moves (Q, R, B, N) for a pawn move */
+static inline void AddPromotions(
+    int from, int to, int captureFlag,
     Move* moveList, int* moveCount
 ) {
-    Move* m = &moveList[*moveCount];
-    m->from     = from;
-    m->to       = to;
-    m->captured = captured;
-    m->promoted = promoted;
-    m->flag     = flag;
-    (*moveCount)++;
+    int flags = MFLAG_PROMO | captureFlag;
+    AddMove(from, to, flags | (QUEEN  - KNIGHT), moveList, moveCount);
+    AddMove(from, to, flags | (ROOK   - KNIGHT), moveList, moveCount);
+    AddMove(from, to, flags | (BISHOP - KNIGHT), moveList, moveCount);
+    AddMove(from, to, flags | (KNIGHT - KNIGHT), moveList, moveCount);
 }
 
 /*
@@ -57,237 +56,125 @@ static inline void AddMove(
 */
 static void PawnMoves(const Board* b, Move* moveList, int* moveCount, bool capturesOnly) {
     int side = b->side;
-    int pawn = (side == WHITE) ? W_PAWN : B_PAWN;
-    int rankDirection = (side == WHITE) ? 10 : -10;
-
-    int leftCapture  = (side == WHITE) ? 9 : -11;
-    int rightCapture = (side == WHITE) ? 11 : -9;
-
-    for (int sq = 0; sq < BOARD_SIZE; sq++) {
-        if (b->pieces[sq] == pawn) {
-            int from = sq;
-
-            /* 1) Single push forward (non-captures) if not capturesOnly */
-            if (!capturesOnly) {
-                int forwardSq = sq + rankDirection;
-                if (IsOnBoard(forwardSq) && (b->pieces[forwardSq] == EMPTY)) {
-                    int rank = (forwardSq / 10) - 2;
-                    bool isPromotion = false;
-                    if ((side == WHITE && rank == 7) || (side == BLACK && rank == 0)) {
-                        isPromotion = true;
-                    }
-                    if (isPromotion) {
-                        /* Promote to Q, R, B, N */
-                        AddMove(from, forwardSq, EMPTY,
-                                (side == WHITE) ? W_QUEEN : B_QUEEN,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, forwardSq, EMPTY,
-                                (side == WHITE) ? W_ROOK  : B_ROOK,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, forwardSq, EMPTY,
-                                (side == WHITE) ? W_BISHOP: B_BISHOP,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, forwardSq, EMPTY,
-                                (side == WHITE) ? W_KNIGHT: B_KNIGHT,
-                                (1 << 3), moveList, moveCount);
-                    } else {
-                        /* Normal pawn push */
-                        AddMove(from, forwardSq, EMPTY, EMPTY, 0, moveList, moveCount);
-
-                        /* 2) Double push if on initial rank and forwardSq is empty */
-                        bool onInitialRank = false;
-                        if (side == WHITE) {
-                            /* White initial rank => row=3 => (from / 10) - 2 == 1 => from in [31..38] */
-                            if (((from / 10) - 2) == 1) {
-                                onInitialRank = true;
-                            }
-                        } else {
-                            /* Black initial rank => row=8 => (from / 10) - 2 == 6 => from in [81..88] */
-                            if (((from / 10) - 2) == 6) {
-                                onInitialRank = true;
-                            }
-                        }
-                        if (onInitialRank) {
-                            int doubleForward = forwardSq + rankDirection;
-                            if (IsOnBoard(doubleForward) && b->pieces[doubleForward] == EMPTY) {
-                                AddMove(from, doubleForward, EMPTY, EMPTY, (1 << 1), moveList, moveCount);
-                            }
-                        }
+    int push = (side == WHITE) ? 8 : -8;
+    Bitboard pawns     = b->pieceBB[MakePiece(PAWN, side)];
+    Bitboard empty     = ~b->colorBB[BOTH];
+    Bitboard enemy     = b->colorBB[side ^ 1];
+    Bitboard startRank = (side == WHITE) ? RANK_BB(1) : RANK_BB(6);
+    Bitboard promoRank = (side == WHITE) ? RANK_8_BB : RANK_1_BB;
+
+    while (pawns) {
+        int from = PopLsb(&pawns);
+
+        /* 1) Pushes (non-captures) if not capturesOnly */
+        if (!capturesOnly) {
+            int forwardSq = from + push;
+            if (empty & SQ_BB(forwardSq)) {
+                if (promoRank & SQ_BB(forwardSq)) {
+                    AddPromotions(from, forwardSq, MFLAG_QUIET, moveList, moveCount);
+                } else {
+                    AddMove(from, forwardSq, MFLAG_QUIET, moveList, moveCount);
+
+                    /* 2) Double push from the initial rank */
+                    int doubleForward = forwardSq + push;
+                    if ((startRank & SQ_BB(from)) && (empty & SQ_BB(doubleForward))) {
+                        AddMove(from, doubleForward, MFLAG_PAWNSTART, moveList, moveCount);
                     }
                 }
             }
+        }
 
-            /* 3) Captures (left/right diagonal), including en passant */
-            int captureLeft  = sq + leftCapture;
-            int captureRight = sq + rightCapture;
-
-            /* Left capture */
-            if (IsOnBoard(captureLeft)) {
-                int capturedPiece = b->pieces[captureLeft];
-                if (capturedPiece != EMPTY && PieceColor(capturedPiece) != side) {
-                    int rank = (captureLeft / 10) - 2;
-                    bool isPromotion = false;
-                    if ((side == WHITE && rank == 7) || (side == BLACK && rank == 0)) {
-                        /* Promotion capture */
-                        AddMove(from, captureLeft, capturedPiece,
-                                (side == WHITE) ? W_QUEEN : B_QUEEN,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, captureLeft, capturedPiece,
-                                (side == WHITE) ? W_ROOK  : B_ROOK,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, captureLeft, capturedPiece,
-                                (side == WHITE) ? W_BISHOP: B_BISHOP,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, captureLeft, capturedPiece,
-                                (side == WHITE) ? W_KNIGHT: B_KNIGHT,
-                                (1 << 3), moveList, moveCount);
-                    } else {
-                        /* Normal capture */
-                        AddMove(from, captureLeft, capturedPiece, EMPTY, 0, moveList, moveCount);
-                    }
-                }
-                /* En passant capture */
-                if (captureLeft == b->enPas) {
-                    AddMove(from, captureLeft,
-                            (side == WHITE) ? B_PAWN : W_PAWN, 
-                            EMPTY, (1 << 0), moveList, moveCount);
-                }
+        /* 3) Captures, including promotion captures */
+        Bitboard captures = PawnAttacks[side][from] & enemy;
+        while (captures) {
+            int to = PopLsb(&captures);
+            if (promoRank & SQ_BB(to)) {
+                AddPromotions(from, to, MFLAG_CAPTURE, moveList, moveCount);
+            } else {
+                AddMove(from, to, MFLAG_CAPTURE, moveList, moveCount);
             }
+        }
 
-            /* Right capture */
-            if (IsOnBoard(captureRight)) {
-                int capturedPiece = b->pieces[captureRight];
-                if (capturedPiece != EMPTY && PieceColor(capturedPiece) != side) {
-                    int rank = (captureRight / 10) - 2;
-                    bool isPromotion = false;
-                    if ((side == WHITE && rank == 7) || (side == BLACK && rank == 0)) {
-                        /* Promotion capture */
-                        AddMove(from, captureRight, capturedPiece,
-                                (side == WHITE) ? W_QUEEN : B_QUEEN,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, captureRight, capturedPiece,
-                                (side == WHITE) ? W_ROOK  : B_ROOK,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, captureRight, capturedPiece,
-                                (side == WHITE) ? W_BISHOP: B_BISHOP,
-                                (1 << 3), moveList, moveCount);
-                        AddMove(from, captureRight, capturedPiece,
-                                (side == WHITE) ? W_KNIGHT: B_KNIGHT,
-                                (1 << 3), moveList, moveCount);
-                    } else {
-                        /* Normal capture */
-                        AddMove(from, captureRight, capturedPiece, EMPTY, 0, moveList, moveCount);
-                    }
-                }
-                /* En passant capture */
-                if (captureRight == b->enPas) {
-                    AddMove(from, captureRight,
-                            (side == WHITE) ? B_PAWN : W_PAWN, 
-                            EMPTY, (1 << 0), moveList, moveCount);
-                }
-            }
+        /* 4) En passant capture */
+        if (b->enPas != NO_SQ && (PawnAttacks[side][from] & SQ_BB(b->enPas))) {
+            AddMove(from, b->enPas, MFLAG_EP, moveList, moveCount);
         }
     }
 }
 
-/*
-   GenerateSlidingMoves:
-   - For rooks, bishops, queens. We go in each direction until off-board
-     or hitting a piece. If it's an enemy piece, we capture and stop.
-*/
-static void GenerateSlidingMoves(
-    const Board* b, Move* moveList, int* moveCount,
-    int piece, const int* directions, int dirCount, bool capturesOnly
-) {
-    for (int sq = 0; sq < BOARD_SIZE; sq++) {
-        if (b->pieces[sq] == piece) {
-            int from = sq;
-            for (int i = 0; i < dirCount; i++) {
-                int dir = directions[i];
-                int tsq = sq + dir;
-                while (IsOnBoard(tsq)) {
-                    int targetPiece = b->pieces[tsq];
-                    if (targetPiece == EMPTY) {
-                        /* Add non-captures only if capturesOnly == false */
-                        if (!capturesOnly) {
-                            AddMove(from, tsq, EMPTY, EMPTY, 0, moveList, moveCount);
-                        }
-                    } else {
-                        /* Occupied square */
-                        if (PieceColor(targetPiece) != PieceColor(piece)) {
-                            /* Enemy piece => capture */
-                            AddMove(from, tsq, targetPiece, EMPTY, 0, moveList, moveCount);
-                        }
-                        break; /* Stop in any case */
-                    }
-                    tsq += dir;
-                }
-            }
-        }
+/* Attack set of a (non-pawn) piece standing on sq */
+static inline Bitboard PieceAttacks(int piece, int sq, Bitboard occ)
+{
+    switch (PieceType(piece)) {
+        case KNIGHT: return KnightAttacks[sq];
+        case BISHOP: return BishopAttacks(sq, occ);
+        case ROOK:   return RookAttacks(sq, occ);
+        case QUEEN:  return QueenAttacks(sq, occ);
+        case KING:   return KingAttacks[sq];
+        default:     return 0ULL;
     }
 }
 
 /*
-   GenerateLeaperMoves:
-   - For knights, kings. Each offset is checked once. 
-   - If capturesOnly == true, we skip empty squares.
+   GeneratePieceMoves:
+   - For knights, bishops, rooks, queens and kings. Each piece's attack
+     set is masked with targets (enemy pieces only, or anything not ours).
 */
-static void GenerateLeaperMoves(
+static void GeneratePieceMoves(
     const Board* b, Move* moveList, int* moveCount,
-    int piece, const int* offsets, int offsetCount, bool capturesOnly
+    int piece, Bitboard targets
 ) {
-    for (int sq = 0; sq < BOARD_SIZE; sq++) {
-        if (b->pieces[sq] == piece) {
-            int from = sq;
-            for (int i = 0; i < offsetCount; i++) {
-                int tsq = sq + offsets[i];
-                if (IsOnBoard(tsq)) {
-                    int targetPiece = b->pieces[tsq];
-                    if (targetPiece == EMPTY) {
-                        if (!capturesOnly) {
-                            AddMove(from, tsq, EMPTY, EMPTY, 0, moveList, moveCount);
-                        }
-                    } else {
-                        /* Capture if enemy */
-                        if (PieceColor(targetPiece) != PieceColor(piece)) {
-                            AddMove(from, tsq, targetPiece, EMPTY, 0, moveList, moveCount);
-                        }
-                    }
-                }
-            }
+    Bitboard pieces = b->pieceBB[piece];
+    Bitboard occ = b->colorBB[BOTH];
+
+    while (pieces) {
+        int from = PopLsb(&pieces);
+        Bitboard attacks = PieceAttacks(piece, from, occ) & targets;
+        while (attacks) {
+            int to = PopLsb(&attacks);
+            AddMove(from, to, CaptureFlag(b, to), moveList, moveCount);
         }
     }
 }
 
 /*
    GenerateCastling:
-   - Adds castling moves if available. Currently a placeholder that
-     doesn't do thorough checks for check or blockages. 
+   - Adds castling moves if the rights are still held, the squares between
+     king and rook are empty, and the king does not start in, pass through
+     or land on an attacked square.
 */
 static void GenerateCastling(
     const Board* b, Move* moveList, int* moveCount, bool capturesOnly
 ) {
     if (capturesOnly) return; /* Can't capture with castling */
 
-    /* Example skeleton (not fully implemented) */
-    /*
+    Bitboard occ = b->colorBB[BOTH];
+
     if (b->side == WHITE) {
-        if (b->castlePerm & WKCA) {
-            // Check squares e1..g1 are free, not attacked, etc.
-            // If valid, AddMove(...).
+        /* e1 = 4, f1 = 5, g1 = 6, d1 = 3, c1 = 2, b1 = 1 */
+        if ((b->castlePerm & WKCA) && !(occ & (SQ_BB(5) | SQ_BB(6))) &&
+            !IsSquareAttacked(b, 4, BLACK) && !IsSquareAttacked(b, 5, BLACK) &&
+            !IsSquareAttacked(b, 6, BLACK)) {
+            AddMove(4, 6, MFLAG_KING_CASTLE, moveList, moveCount);
         }
-        if (b->castlePerm & WQCA) {
-            // Check squares e1..c1 are free, not attacked, etc.
+        if ((b->castlePerm & WQCA) && !(occ & (SQ_BB(1) | SQ_BB(2) | SQ_BB(3))) &&
+            !IsSquareAttacked(b, 4, BLACK) && !IsSquareAttacked(b, 3, BLACK) &&
+            !IsSquareAttacked(b, 2, BLACK)) {
+            AddMove(4, 2, MFLAG_QUEEN_CASTLE, moveList, moveCount);
         }
     } else {
-        if (b->castlePerm & BKCA) {
-            // ...
+        /* e8 = 60, f8 = 61, g8 = 62, d8 = 59, c8 = 58, b8 = 57 */
+        if ((b->castlePerm & BKCA) && !(occ & (SQ_BB(61) | SQ_BB(62))) &&
+            !IsSquareAttacked(b, 60, WHITE) && !IsSquareAttacked(b, 61, WHITE) &&
+            !IsSquareAttacked(b, 62, WHITE)) {
+            AddMove(60, 62, MFLAG_KING_CASTLE, moveList, moveCount);
         }
-        if (b->castlePerm & BQCA) {
-            // ...
+        if ((b->castlePerm & BQCA) && !(occ & (SQ_BB(57) | SQ_BB(58) | SQ_BB(59))) &&
+            !IsSquareAttacked(b, 60, WHITE) && !IsSquareAttacked(b, 59, WHITE) &&
+            !IsSquareAttacked(b, 58, WHITE)) {
+            AddMove(60, 58, MFLAG_QUEEN_CASTLE, moveList, moveCount);
         }
     }
-    */
 }
 
 /*
@@ -298,26 +185,15 @@ static void GenerateCastling(
 int GenerateAllMoves(const Board* b, Move* moveList)
 {
     int moveCount = 0;
+    int side = b->side;
+    Bitboard targets = ~b->colorBB[side];
 
     /* 1) Pawn moves (captures + non-captures) */
     PawnMoves(b, moveList, &moveCount, false);
 
     /* 2) Other pieces */
-    if (b->side == WHITE) {
-        GenerateLeaperMoves(b, moveList, &moveCount, W_KNIGHT, KnightOffsets, 8, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_BISHOP, BishopOffsets, 4, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_ROOK,   RookOffsets,   4, false);
-        /* A queen is basically bishop + rook moves */
-        GenerateSlidingMoves(b, moveList, &moveCount, W_QUEEN,  BishopOffsets, 4, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_QUEEN,  RookOffsets,   4, false);
-        GenerateLeaperMoves(b, moveList, &moveCount, W_KING,   KingOffsets,    8, false);
-    } else {
-        GenerateLeaperMoves(b, moveList, &moveCount, B_KNIGHT, KnightOffsets, 8, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_BISHOP, BishopOffsets, 4, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_ROOK,   RookOffsets,   4, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_QUEEN,  BishopOffsets, 4, false);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_QUEEN,  RookOffsets,   4, false);
-        GenerateLeaperMoves(b, moveList, &moveCount, B_KING,   KingOffsets,    8, false);
+    for (int type = KNIGHT; type <= KING; type++) {
+        GeneratePieceMoves(b, moveList, &moveCount, MakePiece(type, side), targets);
     }
 
     /* 3) Castling */
@@ -334,25 +210,15 @@ int GenerateAllMoves(const Board* b, Move* moveList)
 int GenerateCaptures(const Board* b, Move* moveList)
 {
     int moveCount = 0;
+    int side = b->side;
+    Bitboard targets = b->colorBB[side ^ 1];
 
     /* Pawn captures (including en passant) */
     PawnMoves(b, moveList, &moveCount, true);
 
     /* Leapers & sliders, captures only */
-    if (b->side == WHITE) {
-        GenerateLeaperMoves(b, moveList, &moveCount, W_KNIGHT, KnightOffsets, 8, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_BISHOP, BishopOffsets, 4, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_ROOK,   RookOffsets,   4, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_QUEEN,  BishopOffsets, 4, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, W_QUEEN,  RookOffsets,   4, true);
-        GenerateLeaperMoves(b, moveList, &moveCount, W_KING,   KingOffsets,    8, true);
-    } else {
-        GenerateLeaperMoves(b, moveList, &moveCount, B_KNIGHT, KnightOffsets, 8, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_BISHOP, BishopOffsets, 4, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_ROOK,   RookOffsets,   4, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_QUEEN,  BishopOffsets, 4, true);
-        GenerateSlidingMoves(b, moveList, &moveCount, B_QUEEN,  RookOffsets,   4, true);
-        GenerateLeaperMoves(b, moveList, &moveCount, B_KING,   KingOffsets,    8, true);
+    for (int type = KNIGHT; type <= KING; type++) {
+        GeneratePieceMoves(b, moveList, &moveCount, MakePiece(type, side), targets);
     }
 
     return moveCount;
@@ -361,79 +227,327 @@ int GenerateCaptures(const Board* b, Move* moveList)
 /*
    IsSquareAttacked:
    - Checks if 'square' is attacked by 'side'.
-   - Looks for pawn, knight, bishop, rook, queen, and king attacks.
+   - Looks up the attack sets from 'square' for each piece type and tests
+     them against the attacker's bitboards (attacks are symmetric, except
+     for pawns, where the opposite color's table is used).
 */
 bool IsSquareAttacked(const Board* b, int square, int side)
 {
-    /* 1) Pawn attacks */
-    if (side == WHITE) {
-        int left = square - 9;
-        int right= square - 11;
-        if (IsOnBoard(left)  && b->pieces[left]  == W_PAWN) return true;
-        if (IsOnBoard(right) && b->pieces[right] == W_PAWN) return true;
-    } else {
-        int left = square + 9;
-        int right= square + 11;
-        if (IsOnBoard(left)  && b->pieces[left]  == B_PAWN) return true;
-        if (IsOnBoard(right) && b->pieces[right] == B_PAWN) return true;
+    Bitboard occ = b->colorBB[BOTH];
+
+    if (PawnAttacks[side ^ 1][square] & b->pieceBB[MakePiece(PAWN, side)]) return true;
+    if (KnightAttacks[square] & b->pieceBB[MakePiece(KNIGHT, side)]) return true;
+    if (KingAttacks[square] & b->pieceBB[MakePiece(KING, side)]) return true;
+
+    Bitboard queens = b->pieceBB[MakePiece(QUEEN, side)];
+    if (BishopAttacks(square, occ) & (b->pieceBB[MakePiece(BISHOP, side)] | queens)) return true;
+    if (RookAttacks(square, occ) & (b->pieceBB[MakePiece(ROOK, side)] | queens)) return true;
+
+    /* Not attacked if we reach here */
+    return false;
+}
+
+/*
+   AttackersTo:
+   - Returns every piece (of both colors) attacking sq, with occ as the
+     board occupancy. Passing a modified occ lets callers ask "what would
+     attack this square if these pieces moved".
+*/
+Bitboard AttackersTo(const Board* b, int sq, Bitboard occ)
+{
+    Bitboard bishops = b->pieceBB[W_BISHOP] | b->pieceBB[B_BISHOP]
+                     | b->pieceBB[W_QUEEN]  | b->pieceBB[B_QUEEN];
+    Bitboard rooks   = b->pieceBB[W_ROOK]   | b->pieceBB[B_ROOK]
+                     | b->pieceBB[W_QUEEN]  | b->pieceBB[B_QUEEN];
+
+    return (PawnAttacks[BLACK][sq] & b->pieceBB[W_PAWN])
+         | (PawnAttacks[WHITE][sq] & b->pieceBB[B_PAWN])
+         | (KnightAttacks[sq] & (b->pieceBB[W_KNIGHT] | b->pieceBB[B_KNIGHT]))
+         | (KingAttacks[sq]   & (b->pieceBB[W_KING]   | b->pieceBB[B_KING]))
+         | (BishopAttacks(sq, occ) & bishops)
+         | (RookAttacks(sq, occ)   & rooks);
+}
+
+/*
+   PinnedPieces:
+   - Pieces of 'side' that are the only blocker between their king and an
+     enemy slider. They may only move along the line through the king.
+*/
+static Bitboard PinnedPieces(const Board* b, int side, int ksq)
+{
+    int them = side ^ 1;
+    Bitboard queens  = b->pieceBB[MakePiece(QUEEN, them)];
+    Bitboard snipers = (RookAttacks(ksq, 0ULL)   & (b->pieceBB[MakePiece(ROOK, them)]   | queens))
+                     | (BishopAttacks(ksq, 0ULL) & (b->pieceBB[MakePiece(BISHOP, them)] | queens));
+    Bitboard pinned = 0ULL;
+
+    while (snipers) {
+        int sniper = PopLsb(&snipers);
+        Bitboard blockers = BetweenBB[ksq][sniper] & b->colorBB[BOTH];
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & b->colorBB[side])) {
+            pinned |= blockers;
+        }
     }
 
-    /* 2) Knight attacks */
-    for (int i = 0; i < 8; i++) {
-        int sqKnight = square + KnightOffsets[i];
-        if (IsOnBoard(sqKnight)) {
-            int piece = b->pieces[sqKnight];
-            if (side == WHITE && piece == W_KNIGHT) return true;
-            if (side == BLACK && piece == B_KNIGHT) return true;
+    return pinned;
+}
+
+/*
+   EnPassantIsLegal:
+   - En passant removes two pieces from one rank at once, which pin masks
+     cannot describe (e.g. king and rook on the 5th rank). Re-test the
+     king against sliders with the post-capture occupancy instead.
+*/
+static bool EnPassantIsLegal(const Board* b, int from, int ksq)
+{
+    int side  = b->side;
+    int them  = side ^ 1;
+    int to    = b->enPas;
+    int capSq = (side == WHITE) ? to - 8 : to + 8;
+    Bitboard occ = (b->colorBB[BOTH] ^ SQ_BB(from) ^ SQ_BB(capSq)) | SQ_BB(to);
+    Bitboard queens = b->pieceBB[MakePiece(QUEEN, them)];
+
+    /* Non-slider checks are unaffected by the capture, except the pawn itself */
+    Bitboard others = (PawnAttacks[side][ksq] & b->pieceBB[MakePiece(PAWN, them)] & ~SQ_BB(capSq))
+                    | (KnightAttacks[ksq] & b->pieceBB[MakePiece(KNIGHT, them)]);
+    if (others) return false;
+
+    return !(RookAttacks(ksq, occ)   & (b->pieceBB[MakePiece(ROOK, them)]   | queens))
+        && !(BishopAttacks(ksq, occ) & (b->pieceBB[MakePiece(BISHOP, them)] | queens));
+}
+
+/* Which legal moves GenerateLegal emits */
+typedef enum {
+    GEN_ALL,      /* Everything */
+    GEN_CAPTURES, /* Captures, en passant and capturing promotions */
+    GEN_QUIETS    /* The rest: pushes (promotions too), castling, quiet piece moves */
+} GenType;
+
+/*
+   GenerateLegal:
+   - Shared body of the legal generators.
+   - checkMask: squares a non-king move must land on (anything when not in
+     check; the checker and the squares between it and the king in single
+     check). In double check only the king may move.
+   - GEN_CAPTURES and GEN_QUIETS split GEN_ALL into two disjoint halves.
+*/
+static int GenerateLegal(const Board* b, Move* moveList, GenType genType)
+{
+    int moveCount = 0;
+    int side  = b->side;
+    int them  = side ^ 1;
+    int ksq   = KingSquare(b, side);
+    Bitboard us    = b->colorBB[side];
+    Bitboard enemy = b->colorBB[them];
+    Bitboard occ   = b->colorBB[BOTH];
+
+    Bitboard checkers = AttackersTo(b, ksq, occ) & enemy;
+    Bitboard pinned   = PinnedPieces(b, side, ksq);
+    Bitboard targets  = (genType == GEN_CAPTURES) ? enemy
+                      : (genType == GEN_QUIETS)   ? ~occ
+                      : ~us;
+
+    /* 1) King moves: the target must be safe with the king off its square */
+    Bitboard kingTargets = KingAttacks[ksq] & targets;
+    Bitboard occNoKing   = occ ^ SQ_BB(ksq);
+    while (kingTargets) {
+        int to = PopLsb(&kingTargets);
+        if (!(AttackersTo(b, to, occNoKing) & enemy)) {
+            AddMove(ksq, to, CaptureFlag(b, to), moveList, &moveCount);
         }
     }
 
-    /* 3) Bishop/Queen (diagonals) */
-    for (int i = 0; i < 4; i++) {
-        int dir = BishopOffsets[i];
-        int tsq = square + dir;
-        while (IsOnBoard(tsq)) {
-            int piece = b->pieces[tsq];
-            if (piece != EMPTY) {
-                if ((side == WHITE && (piece == W_BISHOP || piece == W_QUEEN)) ||
-                    (side == BLACK && (piece == B_BISHOP || piece == B_QUEEN))) {
-                    return true;
-                }
-                break; /* Blocked */
+    /* Double check: nothing else can help */
+    if (checkers & (checkers - 1)) {
+        return moveCount;
+    }
+
+    Bitboard checkMask = ~0ULL;
+    if (checkers) {
+        checkMask = BetweenBB[ksq][Lsb(checkers)] | checkers;
+    }
+
+    /* 2) Pawns */
+    int push = (side == WHITE) ? 8 : -8;
+    Bitboard empty     = ~occ;
+    Bitboard startRank = (side == WHITE) ? RANK_BB(1) : RANK_BB(6);
+    Bitboard promoRank = (side == WHITE) ? RANK_8_BB : RANK_1_BB;
+    Bitboard pawns     = b->pieceBB[MakePiece(PAWN, side)];
+
+    while (pawns) {
+        int from = PopLsb(&pawns);
+        Bitboard allowed = checkMask;
+        if (pinned & SQ_BB(from)) {
+            allowed &= LineBB[ksq][from];
+        }
+
+        Bitboard pawnTargets = 0ULL;
+        if (genType != GEN_QUIETS) {
+            pawnTargets |= PawnAttacks[side][from] & enemy;
+        }
+        if (genType != GEN_CAPTURES && (empty & SQ_BB(from + push))) {
+            pawnTargets |= SQ_BB(from + push);
+            if ((startRank & SQ_BB(from)) && (empty & SQ_BB(from + 2 * push))) {
+                pawnTargets |= SQ_BB(from + 2 * push);
             }
-            tsq += dir;
         }
-    }
+        pawnTargets &= allowed;
 
-    /* 4) Rook/Queen (straight lines) */
-    for (int i = 0; i < 4; i++) {
-        int dir = RookOffsets[i];
-        int tsq = square + dir;
-        while (IsOnBoard(tsq)) {
-            int piece = b->pieces[tsq];
-            if (piece != EMPTY) {
-                if ((side == WHITE && (piece == W_ROOK || piece == W_QUEEN)) ||
-                    (side == BLACK && (piece == B_ROOK || piece == B_QUEEN))) {
-                    return true;
-                }
-                break; /* Blocked */
+        while (pawnTargets) {
+            int to = PopLsb(&pawnTargets);
+            if (promoRank & SQ_BB(to)) {
+                AddPromotions(from, to, CaptureFlag(b, to), moveList, &moveCount);
             }
-            tsq += dir;
+            else {
+                int flags = (to - from == 2 * push) ? MFLAG_PAWNSTART : CaptureFlag(b, to);
+                AddMove(from, to, flags, moveList, &moveCount);
+            }
+        }
+
+        if (genType != GEN_QUIETS && b->enPas != NO_SQ
+            && (PawnAttacks[side][from] & SQ_BB(b->enPas))
+            && EnPassantIsLegal(b, from, ksq)) {
+            AddMove(from, b->enPas, MFLAG_EP, moveList, &moveCount);
         }
     }
 
-    /* 5) King attacks (adjacent squares) */
-    for (int i = 0; i < 8; i++) {
-        int sqKing = square + KingOffsets[i];
-        if (IsOnBoard(sqKing)) {
-            int piece = b->pieces[sqKing];
-            if ((side == WHITE && piece == W_KING) ||
-                (side == BLACK && piece == B_KING)) {
-                return true;
+    /* 3) Knights, bishops, rooks, queens */
+    for (int type = KNIGHT; type <= QUEEN; type++) {
+        Bitboard pieces = b->pieceBB[MakePiece(type, side)];
+        while (pieces) {
+            int from = PopLsb(&pieces);
+            Bitboard attacks = PieceAttacks(MakePiece(type, side), from, occ) & targets & checkMask;
+            if (pinned & SQ_BB(from)) {
+                attacks &= LineBB[ksq][from];
+            }
+            while (attacks) {
+                int to = PopLsb(&attacks);
+                AddMove(from, to, CaptureFlag(b, to), moveList, &moveCount);
             }
         }
     }
 
-    /* Not attacked if we reach here */
-    return false;
+    /* 4) Castling (never out of check; path safety is tested inside) */
+    if (!checkers) {
+        GenerateCastling(b, moveList, &moveCount, genType == GEN_CAPTURES);
+    }
+
+    return moveCount;
+}
+
+/*
+   GenerateLegalMoves:
+   - Generates only legal moves for the side to move.
+   - Returns the number of moves stored in moveList (0 = mate or stalemate).
+*/
+int GenerateLegalMoves(const Board* b, Move* moveList)
+{
+    return GenerateLegal(b, moveList, GEN_ALL);
+}
+
+/*
+   GenerateLegalCaptures:
+   - Legal captures only (including en passant and capturing promotions),
+     for the quiescence search.
+*/
+int GenerateLegalCaptures(const Board* b, Move* moveList)
+{
+    return GenerateLegal(b, moveList, GEN_CAPTURES);
+}
+
+/*
+   GenerateLegalQuiets:
+   - Legal non-captures only: pushes (including promotions), castling and
+     quiet piece moves. Together with GenerateLegalCaptures this yields
+     exactly the moves of GenerateLegalMoves.
+*/
+int GenerateLegalQuiets(const Board* b, Move* moveList)
+{
+    return GenerateLegal(b, moveList, GEN_QUIETS);
+}
+
+/*
+   IsValidMove:
+   - Tests whether a move from elsewhere (TT, killer slots) is legal in this
+     position, i.e. whether GenerateLegalMoves would produce exactly these
+     16 bits. Avoids generating all moves just to check one.
+*/
+bool IsValidMove(const Board* b, Move move)
+{
+    if (move == NOMOVE) return false;
+
+    int side  = b->side;
+    int them  = side ^ 1;
+    int from  = FromSq(move);
+    int to    = ToSq(move);
+    int flags = MoveFlags(move);
+    int piece = b->pieces[from];
+
+    if (piece == EMPTY || PieceColor(piece) != side) return false;
+    if (b->pieces[to] != EMPTY && PieceColor(b->pieces[to]) == side) return false;
+
+    int ksq = KingSquare(b, side);
+    Bitboard occ      = b->colorBB[BOTH];
+    Bitboard enemy    = b->colorBB[them];
+    Bitboard checkers = AttackersTo(b, ksq, occ) & enemy;
+
+    /* Castling and en passant: compare against the generator's own tests */
+    if (IsCastle(move)) {
+        Move castles[2];
+        int count = 0;
+        if (piece != MakePiece(KING, side) || checkers) return false;
+        GenerateCastling(b, castles, &count, false);
+        for (int i = 0; i < count; i++) {
+            if (castles[i] == move) return true;
+        }
+        return false;
+    }
+    if (flags == MFLAG_EP) {
+        return piece == MakePiece(PAWN, side) && b->enPas == to
+            && (PawnAttacks[side][from] & SQ_BB(to))
+            && EnPassantIsLegal(b, from, ksq);
+    }
+
+    /* The capture flag must match the board */
+    bool isCapture = (b->pieces[to] != EMPTY);
+    if (IsCapture(move) != isCapture) return false;
+
+    if (PieceType(piece) == PAWN) {
+        int push = (side == WHITE) ? 8 : -8;
+        Bitboard promoRank = (side == WHITE) ? RANK_8_BB : RANK_1_BB;
+        Bitboard startRank = (side == WHITE) ? RANK_BB(1) : RANK_BB(6);
+
+        if (IsPromotion(move) != ((promoRank & SQ_BB(to)) != 0)) return false;
+        if (!IsPromotion(move) && flags != MFLAG_QUIET && flags != MFLAG_PAWNSTART
+            && flags != MFLAG_CAPTURE) return false;
+
+        if (isCapture) {
+            if (!(PawnAttacks[side][from] & SQ_BB(to))) return false;
+        }
+        else if (flags == MFLAG_PAWNSTART) {
+            if (!(startRank & SQ_BB(from)) || to != from + 2 * push
+                || (occ & SQ_BB(from + push))) return false;
+        }
+        else if (to != from + push) {
+            return false;
+        }
+    }
+    else {
+        /* Only plain quiet/capture flags are possible for pieces */
+        if (flags & ~MFLAG_CAPTURE) return false;
+        if (!(PieceAttacks(piece, from, occ) & SQ_BB(to))) return false;
+    }
+
+    /* King safety */
+    if (PieceType(piece) == KING) {
+        return !(AttackersTo(b, to, occ ^ SQ_BB(from)) & enemy);
+    }
+    if (checkers) {
+        if (checkers & (checkers - 1)) return false;
+        if (!((BetweenBB[ksq][Lsb(checkers)] | checkers) & SQ_BB(to))) return false;
+    }
+    if ((PinnedPieces(b, side, ksq) & SQ_BB(from)) && !(LineBB[ksq][from] & SQ_BB(to))) {
+        return false;
+    }
+    return true;
 }
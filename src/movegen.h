@@ -11,9 +11,14 @@
       1) int GenerateAllMoves(const Board* b, Move* moveList);
       2) int GenerateCaptures(const Board* b, Move* moveList);
       3) bool IsSquareAttacked(const Board* b, int square, int side);
+      4) int GenerateLegalMoves(const Board* b, Move* moveList);
+      5) Bitboard AttackersTo(const Board* b, int sq, Bitboard occ);
+      6) int GenerateLegalCaptures(const Board* b, Move* moveList);
+      7) int GenerateLegalQuiets(const Board* b, Move* moveList);
+      8) bool IsValidMove(const Board* b, Move move);
 
     Data structures:
-    - Move: a struct with fields for from, to, captured, promoted, flags.
+    - Move: a packed 16-bit move (from, to, flags), see move.h.
 */
 
 #ifndef MOVEGEN_H
@@ -22,6 +27,9 @@
 #include "board.h"
 #include "move.h" /* Include move.h to use Move structure */
 
+/* Upper bound on the number of moves in any position (218 is the known maximum) */
+#define MAX_POSITION_MOVES 256
+
 /* Function prototypes */
 
 /* Generate all pseudo-legal moves (captures, non-captures, castling, etc.) */
@@ -33,4 +41,19 @@ int GenerateCaptures(const Board* b, Move* moveList);
 /* Check if a given square is attacked by a particular side */
 bool IsSquareAttacked(const Board* b, int square, int side);
 
+/* Generate only legal moves (evasions in check, pins respected) */
+int GenerateLegalMoves(const Board* b, Move* moveList);
+
+/* Generate only legal captures (for quiescence search) */
+int GenerateLegalCaptures(const Board* b, Move* moveList);
+
+/* Generate only legal non-captures (the complement of the above) */
+int GenerateLegalQuiets(const Board* b, Move* moveList);
+
+/* Fast legality test for a single move (e.g. from the TT or killer slots) */
+bool IsValidMove(const Board* b, Move move);
+
+/* All pieces of both colors attacking sq, given occupancy occ */
+Bitboard AttackersTo(const Board* b, int sq, Bitboard occ);
+
 #endif /* MOVEGEN_H */
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * File: movepicker.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of the staged move picker.
+    - Every move is handed out once: the capture and quiet lists skip the
+      TT move, and the quiet list also skips the killers already tried.
+    - Captures that lose material by SEE are set aside when the capture
+      stage reaches them and only tried after all quiet moves.
+    - Captures and quiets come from the legal generators, and the TT move
+      and killers are checked with IsValidMove, so every move returned is
+      legal and the search needs no make/unmake test.
+*/
+
+#include "movepicker.h"
+#include "see.h"
+#include <stddef.h> /* For NULL */
+
+/* Picker stages, in the order they run */
+enum {
+    STAGE_TT,
+    STAGE_GEN_CAPTURES,
+    STAGE_CAPTURES,
+    STAGE_KILLER_1,
+    STAGE_KILLER_2,
+    STAGE_GEN_QUIETS,
+    STAGE_QUIETS,
+    STAGE_BAD_CAPTURES,
+    STAGE_DONE,
+
+    /* Quiescence search */
+    STAGE_QS_GEN_CAPTURES,
+    STAGE_QS_CAPTURES
+};
+
+/* Counts a picker event for the search statistics, when enabled */
+#ifdef SEARCH_STATS
+#define PICKER_STAT(mp, field) do { if ((mp)->stats) (mp)->stats->field++; } while (0)
+#else
+#define PICKER_STAT(mp, field) ((void)0)
+#endif
+
+/* Bonus that puts a quiet queen promotion ahead of every history score */
+#define PROMO_BONUS (1 << 20)
+
+/*
+    InitMovePicker:
+    - The killers are copied, since the caller may overwrite its slots
+      while this node is still being searched.
+*/
+void InitMovePicker(MovePicker* mp, const Board* b, Move ttMove,
+                    const Move* killers, const int (*history)[BOARD_SIZE])
+{
+    mp->board      = b;
+    mp->history    = history;
+    mp->ttMove     = IsValidMove(b, ttMove) ? ttMove : NOMOVE;
+    mp->killers[0] = killers ? killers[0] : NOMOVE;
+    mp->killers[1] = killers ? killers[1] : NOMOVE;
+    mp->stage      = (mp->ttMove != NOMOVE) ? STAGE_TT : STAGE_GEN_CAPTURES;
+    mp->count      = 0;
+    mp->index      = 0;
+    mp->badCount   = 0;
+    mp->badIndex   = 0;
+#ifdef SEARCH_STATS
+    mp->stats      = NULL;
+#endif
+}
+
+void InitQuiescencePicker(MovePicker* mp, const Board* b)
+{
+    InitMovePicker(mp, b, NOMOVE, NULL, NULL);
+    mp->stage = STAGE_QS_GEN_CAPTURES;
+}
+
+/* MVV-LVA: victim type first, then the cheapest attacker, plus promotions */
+static void ScoreCaptures(MovePicker* mp)
+{
+    const Board* b = mp->board;
+    for (int i = 0; i < mp->count; i++) {
+        Move m = mp->moves[i];
+        int victim   = IsEnPassant(m) ? PAWN : PieceType(b->pieces[ToSq(m)]);
+        int attacker = PieceType(b->pieces[FromSq(m)]);
+        mp->scores[i] = victim * 8 - attacker;
+        if (IsPromotion(m)) {
+            mp->scores[i] += PromotedType(m) * 8;
+        }
+    }
+}
+
+static void ScoreQuiets(MovePicker* mp)
+{
+    const Board* b = mp->board;
+    for (int i = 0; i < mp->count; i++) {
+        Move m = mp->moves[i];
+        mp->scores[i] = mp->history ? mp->history[b->pieces[FromSq(m)]][ToSq(m)] : 0;
+        if (IsPromotion(m) && PromotedType(m) == QUEEN) {
+            mp->scores[i] += PROMO_BONUS;
+        }
+    }
+}
+
+/* Swaps the best remaining move to mp->index and returns it (lazy selection sort) */
+static Move PickBest(MovePicker* mp)
+{
+    int best = mp->index;
+    for (int i = mp->index + 1; i < mp->count; i++) {
+        if (mp->scores[i] > mp->scores[best]) {
+            best = i;
+        }
+    }
+
+    Move m = mp->moves[best];
+    int  s = mp->scores[best];
+    mp->moves[best]  = mp->moves[mp->index];
+    mp->scores[best] = mp->scores[mp->index];
+    mp->moves[mp->index]  = m;
+    mp->scores[mp->index] = s;
+    mp->index++;
+    return m;
+}
+
+/* A killer is only played if it is a legal quiet move here */
+static bool UsableKiller(const MovePicker* mp, Move killer)
+{
+    return killer != NOMOVE && killer != mp->ttMove && !IsCapture(killer)
+        && IsValidMove(mp->board, killer);
+}
+
+/*
+    NextMove:
+    - Runs through the stages, falling through to the next one whenever
+      the current stage has nothing (left) to give.
+*/
+Move NextMove(MovePicker* mp)
+{
+    while (true) {
+        switch (mp->stage) {
+            case STAGE_TT:
+                mp->stage = STAGE_GEN_CAPTURES;
+                PICKER_STAT(mp, pickTT);
+                return mp->ttMove;
+
+            case STAGE_GEN_CAPTURES:
+            case STAGE_QS_GEN_CAPTURES:
+                if (mp->stage == STAGE_GEN_CAPTURES) PICKER_STAT(mp, genCaptures);
+                else                                 PICKER_STAT(mp, genQsCaptures);
+                mp->count = GenerateLegalCaptures(mp->board, mp->moves);
+                mp->index = 0;
+                ScoreCaptures(mp);
+                mp->stage++;
+                break;
+
+            case STAGE_CAPTURES:
+                while (mp->index < mp->count) {
+                    Move m = PickBest(mp);
+                    if (m == mp->ttMove) continue;
+                    if (IsLosingCapture(mp->board, m)) {
+                        mp->badCaptures[mp->badCount++] = m; /* Try after the quiets */
+                        continue;
+                    }
+                    return m;
+                }
+                mp->stage = STAGE_KILLER_1;
+                break;
+
+            case STAGE_QS_CAPTURES:
+                if (mp->index < mp->count) {
+                    return PickBest(mp);
+                }
+                mp->stage = STAGE_DONE;
+                break;
+
+            case STAGE_KILLER_1:
+                mp->stage = STAGE_KILLER_2;
+                if (UsableKiller(mp, mp->killers[0])) {
+                    PICKER_STAT(mp, pickKillers);
+                    return mp->killers[0];
+                }
+                break;
+
+            case STAGE_KILLER_2:
+                mp->stage = STAGE_GEN_QUIETS;
+                if (mp->killers[1] != mp->killers[0] && UsableKiller(mp, mp->killers[1])) {
+                    PICKER_STAT(mp, pickKillers);
+                    return mp->killers[1];
+                }
+                break;
+
+            case STAGE_GEN_QUIETS:
+                PICKER_STAT(mp, genQuiets);
+                mp->count = GenerateLegalQuiets(mp->board, mp->moves);
+                mp->index = 0;
+                ScoreQuiets(mp);
+                mp->stage = STAGE_QUIETS;
+                break;
+
+            case STAGE_QUIETS:
+                while (mp->index < mp->count) {
+                    Move m = PickBest(mp);
+                    if (m != mp->ttMove && m != mp->killers[0] && m != mp->killers[1]) {
+                        return m;
+                    }
+                }
+                mp->stage = STAGE_BAD_CAPTURES;
+                break;
+
+            case STAGE_BAD_CAPTURES:
+                if (mp->badIndex < mp->badCount) {
+                    return mp->badCaptures[mp->badIndex++];
+                }
+                mp->stage = STAGE_DONE;
+                break;
+
+            default:
+                return NOMOVE;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/****************************************************************************
+ * File: movepicker.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the staged move picker used by the search.
+    - Hands out a node's moves one at a time, best guesses first, and only
+      generates (and scores) each group of moves when it is reached:
+        1) the TT move, checked with IsValidMove, before anything is generated
+        2) winning and equal captures, by MVV-LVA (most valuable victim,
+           least valuable attacker)
+        3) the two killer moves of this ply
+        4) quiet moves, by the history table
+        5) captures that lose material by SEE, in the order they were found
+    - Selection is lazy: each call picks the best remaining move of the
+      current stage, so a cutoff after the first move sorts nothing.
+*/
+
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "board.h"
+#include "movegen.h"
+#include "stats.h"
+
+/* Picker state for one node */
+typedef struct {
+    const Board* board;
+    const int (*history)[BOARD_SIZE]; /* [piece][to] quiet move scores */
+    Move ttMove;
+    Move killers[2];
+    int stage;
+    int count;                        /* Moves in the current stage's list */
+    int index;                        /* Next move to hand out */
+    Move moves[MAX_POSITION_MOVES];
+    int scores[MAX_POSITION_MOVES];
+    Move badCaptures[MAX_POSITION_MOVES]; /* Deferred losing captures */
+    int badCount;
+    int badIndex;
+#ifdef SEARCH_STATS
+    SearchStats* stats;               /* Stage counters (NULL = don't count) */
+#endif
+} MovePicker;
+
+/* Picker for a full-width node; killers and history may be NULL */
+void InitMovePicker(MovePicker* mp, const Board* b, Move ttMove,
+                    const Move* killers, const int (*history)[BOARD_SIZE]);
+
+/* Picker for the quiescence search: captures only, by MVV-LVA (no SEE split) */
+void InitQuiescencePicker(MovePicker* mp, const Board* b);
+
+/* Next legal move, or NOMOVE when the node has none left */
+Move NextMove(MovePicker* mp);
+
+#endif /* MOVEPICKER_H */
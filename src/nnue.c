@@ -0,0 +1,306 @@
+/****************************************************************************
+ * File: nnue.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of the NNUE evaluation: net loading, accumulator
+      updates and the output layer.
+    - The hot loops (accumulator row add/sub and the clipped ReLU dot
+      product) have AVX-512, AVX2 and NEON versions picked at compile time
+      (see SIMD= in the Makefile), with a portable scalar fallback. All
+      versions compute exactly the same integers.
+    - Net files are read as-is, so this assumes a little-endian host.
+*/
+
+#include "nnue.h"
+#include "board.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#define NNUE_AVX512
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define NNUE_AVX2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define NNUE_NEON
+#endif
+
+/* Keeps a badly scaled net out of the mate score range */
+#define NNUE_MAX_SCORE 10000
+
+typedef struct {
+    _Alignas(64) int16_t ftWeights[NNUE_INPUTS][NNUE_HIDDEN];
+    _Alignas(64) int16_t ftBiases[NNUE_HIDDEN];
+    _Alignas(64) int16_t outWeights[2 * NNUE_HIDDEN];
+    int32_t outBias;
+} Network;
+
+static Network Net;
+static bool NetLoaded = false;
+static bool UseNnue   = true; /* What the user asked for ("Use NNUE") */
+
+bool NnueEnabled = false;
+
+/*
+   Vector kernels. Each works on one NNUE_HIDDEN-long row; NNUE_HIDDEN is a
+   multiple of 32, so no version needs a scalar tail.
+*/
+static inline void AddRow(int16_t* acc, const int16_t* w)
+{
+#if defined(NNUE_AVX512)
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m512i a = _mm512_load_si512((const void*)(acc + i));
+        _mm512_store_si512((void*)(acc + i), _mm512_add_epi16(a, _mm512_load_si512((const void*)(w + i))));
+    }
+#elif defined(NNUE_AVX2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256((const __m256i*)(acc + i));
+        _mm256_store_si256((__m256i*)(acc + i), _mm256_add_epi16(a, _mm256_load_si256((const __m256i*)(w + i))));
+    }
+#elif defined(NNUE_NEON)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        vst1q_s16(acc + i, vaddq_s16(vld1q_s16(acc + i), vld1q_s16(w + i)));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        acc[i] += w[i];
+    }
+#endif
+}
+
+static inline void SubRow(int16_t* acc, const int16_t* w)
+{
+#if defined(NNUE_AVX512)
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m512i a = _mm512_load_si512((const void*)(acc + i));
+        _mm512_store_si512((void*)(acc + i), _mm512_sub_epi16(a, _mm512_load_si512((const void*)(w + i))));
+    }
+#elif defined(NNUE_AVX2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256((const __m256i*)(acc + i));
+        _mm256_store_si256((__m256i*)(acc + i), _mm256_sub_epi16(a, _mm256_load_si256((const __m256i*)(w + i))));
+    }
+#elif defined(NNUE_NEON)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        vst1q_s16(acc + i, vsubq_s16(vld1q_s16(acc + i), vld1q_s16(w + i)));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        acc[i] -= w[i];
+    }
+#endif
+}
+
+/* acc += add - sub in one pass (a piece moving between two squares) */
+static inline void AddSubRow(int16_t* acc, const int16_t* add, const int16_t* sub)
+{
+#if defined(NNUE_AVX512)
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m512i a = _mm512_load_si512((const void*)(acc + i));
+        a = _mm512_add_epi16(a, _mm512_load_si512((const void*)(add + i)));
+        a = _mm512_sub_epi16(a, _mm512_load_si512((const void*)(sub + i)));
+        _mm512_store_si512((void*)(acc + i), a);
+    }
+#elif defined(NNUE_AVX2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256((const __m256i*)(acc + i));
+        a = _mm256_add_epi16(a, _mm256_load_si256((const __m256i*)(add + i)));
+        a = _mm256_sub_epi16(a, _mm256_load_si256((const __m256i*)(sub + i)));
+        _mm256_store_si256((__m256i*)(acc + i), a);
+    }
+#elif defined(NNUE_NEON)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        int16x8_t a = vaddq_s16(vld1q_s16(acc + i), vld1q_s16(add + i));
+        vst1q_s16(acc + i, vsubq_s16(a, vld1q_s16(sub + i)));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        acc[i] += add[i] - sub[i];
+    }
+#endif
+}
+
+/* Sum of clamp(acc[i], 0, NNUE_QA) * w[i] over one row */
+static inline int32_t ClippedDot(const int16_t* acc, const int16_t* w)
+{
+#if defined(NNUE_AVX512)
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i qa   = _mm512_set1_epi16(NNUE_QA);
+    __m512i sum = _mm512_setzero_si512();
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m512i a = _mm512_load_si512((const void*)(acc + i));
+        a = _mm512_min_epi16(_mm512_max_epi16(a, zero), qa);
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(a, _mm512_load_si512((const void*)(w + i))));
+    }
+    return _mm512_reduce_add_epi32(sum);
+#elif defined(NNUE_AVX2)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa   = _mm256_set1_epi16(NNUE_QA);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256((const __m256i*)(acc + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), qa);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, _mm256_load_si256((const __m256i*)(w + i))));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+#elif defined(NNUE_NEON)
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t qa   = vdupq_n_s16(NNUE_QA);
+    int32x4_t sum = vdupq_n_s32(0);
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        int16x8_t a = vminq_s16(vmaxq_s16(vld1q_s16(acc + i), zero), qa);
+        int16x8_t b = vld1q_s16(w + i);
+        sum = vmlal_s16(sum, vget_low_s16(a), vget_low_s16(b));
+        sum = vmlal_high_s16(sum, a, b);
+    }
+    return vaddvq_s32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        int v = acc[i] < 0 ? 0 : (acc[i] > NNUE_QA ? NNUE_QA : acc[i]);
+        sum += v * w[i];
+    }
+    return sum;
+#endif
+}
+
+/*
+   Input index of a piece on a square as seen by one side: own pieces come
+   first, and Black sees the board flipped, so both perspectives share the
+   same weights.
+*/
+static inline int FeatureIndex(int perspective, int piece, int sq)
+{
+    int them = (PieceColor(piece) != perspective);
+    if (perspective == BLACK) sq ^= 56;
+    return them * 384 + (PieceType(piece) - 1) * 64 + sq;
+}
+
+void NnueAddPiece(Accumulator* acc, int piece, int sq)
+{
+    AddRow(acc->values[WHITE], Net.ftWeights[FeatureIndex(WHITE, piece, sq)]);
+    AddRow(acc->values[BLACK], Net.ftWeights[FeatureIndex(BLACK, piece, sq)]);
+}
+
+void NnueSubPiece(Accumulator* acc, int piece, int sq)
+{
+    SubRow(acc->values[WHITE], Net.ftWeights[FeatureIndex(WHITE, piece, sq)]);
+    SubRow(acc->values[BLACK], Net.ftWeights[FeatureIndex(BLACK, piece, sq)]);
+}
+
+void NnueMovePiece(Accumulator* acc, int piece, int from, int to)
+{
+    AddSubRow(acc->values[WHITE], Net.ftWeights[FeatureIndex(WHITE, piece, to)],
+              Net.ftWeights[FeatureIndex(WHITE, piece, from)]);
+    AddSubRow(acc->values[BLACK], Net.ftWeights[FeatureIndex(BLACK, piece, to)],
+              Net.ftWeights[FeatureIndex(BLACK, piece, from)]);
+}
+
+/* Accumulator of a board computed from scratch: biases plus every piece */
+static void BuildAccumulator(const Board* b, Accumulator* acc)
+{
+    memcpy(acc->values[WHITE], Net.ftBiases, sizeof(Net.ftBiases));
+    memcpy(acc->values[BLACK], Net.ftBiases, sizeof(Net.ftBiases));
+
+    for (int piece = W_PAWN; piece <= B_KING; piece++) {
+        Bitboard bb = b->pieceBB[piece];
+        while (bb) {
+            NnueAddPiece(acc, piece, PopLsb(&bb));
+        }
+    }
+}
+
+void NnueRefresh(Board* b)
+{
+    BuildAccumulator(b, &b->acc);
+}
+
+#ifdef DEBUG
+bool NnueCheckAccumulator(const Board* b)
+{
+    static _Thread_local Accumulator fresh;
+    BuildAccumulator(b, &fresh);
+    return !memcmp(&fresh, &b->acc, sizeof(fresh));
+}
+#endif
+
+/*
+    NnueEvaluate:
+    - Output layer over both clipped accumulators, the side to move's first,
+      then scaled back to centipawns.
+*/
+int NnueEvaluate(const Board* b)
+{
+    const Accumulator* acc = &b->acc;
+    int64_t sum = ClippedDot(acc->values[b->side], Net.outWeights)
+                + ClippedDot(acc->values[b->side ^ 1], Net.outWeights + NNUE_HIDDEN)
+                + Net.outBias;
+
+    int score = (int)(sum * NNUE_SCALE / (NNUE_QA * NNUE_QB));
+    if (score >  NNUE_MAX_SCORE) score =  NNUE_MAX_SCORE;
+    if (score < -NNUE_MAX_SCORE) score = -NNUE_MAX_SCORE;
+    return score;
+}
+
+/*
+    NnueLoad:
+    - Checks the header and the exact file size before reading any weights,
+      so a wrong or truncated file leaves the current net untouched.
+    - An empty path or "<empty>" unloads the net.
+*/
+bool NnueLoad(const char* path)
+{
+    if (!path[0] || !strcmp(path, "<empty>")) {
+        NetLoaded   = false;
+        NnueEnabled = false;
+        return false;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+
+    char magic[8];
+    uint32_t version, hidden;
+    long expected = (long)(sizeof(magic) + 2 * sizeof(uint32_t)
+                  + sizeof(Net.ftWeights) + sizeof(Net.ftBiases)
+                  + sizeof(Net.outWeights) + sizeof(Net.outBias));
+
+    bool ok = fread(magic, sizeof(magic), 1, f) == 1
+           && fread(&version, sizeof(version), 1, f) == 1
+           && fread(&hidden, sizeof(hidden), 1, f) == 1
+           && !memcmp(magic, "BEARNNUE", sizeof(magic))
+           && version == NNUE_VERSION
+           && hidden == NNUE_HIDDEN
+           && fseek(f, 0, SEEK_END) == 0
+           && ftell(f) == expected
+           && fseek(f, (long)(sizeof(magic) + 2 * sizeof(uint32_t)), SEEK_SET) == 0;
+
+    if (ok) {
+        /* Past this point a read error leaves a half-written net: drop it */
+        NetLoaded = false;
+        ok = fread(Net.ftWeights, sizeof(Net.ftWeights), 1, f) == 1
+          && fread(Net.ftBiases, sizeof(Net.ftBiases), 1, f) == 1
+          && fread(Net.outWeights, sizeof(Net.outWeights), 1, f) == 1
+          && fread(&Net.outBias, sizeof(Net.outBias), 1, f) == 1;
+        NetLoaded = ok;
+        NnueEnabled = NetLoaded && UseNnue;
+    }
+
+    fclose(f);
+    return ok;
+}
+
+bool NnueSetEnabled(bool enabled)
+{
+    UseNnue     = enabled;
+    NnueEnabled = NetLoaded && UseNnue;
+    return NnueEnabled;
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ * File: nnue.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the NNUE (efficiently updatable neural network) evaluation.
+    - Network: 768 inputs (piece type x color x square, seen from each side)
+      -> NNUE_HIDDEN neurons per perspective -> clipped ReLU -> 1 output.
+    - The first layer's output (the accumulator) lives in the Board and is
+      updated piece by piece as moves are made and unmade, so an evaluation
+      only runs the small output layer.
+    - The net is loaded at runtime from a file (UCI option "EvalFile"); the
+      classical evaluation stays in use until one is loaded and enabled.
+
+    Net file format (all values little-endian):
+        char     magic[8]         "BEARNNUE"
+        uint32_t version          NNUE_VERSION
+        uint32_t hidden           must equal NNUE_HIDDEN
+        int16_t  ftWeights[768][NNUE_HIDDEN]
+        int16_t  ftBiases[NNUE_HIDDEN]
+        int16_t  outWeights[2 * NNUE_HIDDEN]   side to move first
+        int32_t  outBias
+    Quantization: first layer scaled by NNUE_QA, output weights by NNUE_QB,
+    and the output is in units of NNUE_SCALE per 1.0 of the float network.
+*/
+
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NNUE_INPUTS   768
+#define NNUE_HIDDEN   256
+#define NNUE_VERSION  1
+
+#define NNUE_QA       255
+#define NNUE_QB       64
+#define NNUE_SCALE    400
+
+struct Board;
+
+/* First layer output for both perspectives, [WHITE] and [BLACK] */
+typedef struct {
+    _Alignas(64) int16_t values[2][NNUE_HIDDEN];
+} Accumulator;
+
+/* True while a net is loaded and switched on; MakeMove/UnmakeMove only
+   maintain the accumulator then. Only changes between searches. */
+extern bool NnueEnabled;
+
+/* Load a net file. Returns false (keeping the previous net) on any error. */
+bool NnueLoad(const char* path);
+
+/* Switch NNUE evaluation on or off. It stays off while no net is loaded;
+   returns the resulting state. */
+bool NnueSetEnabled(bool enabled);
+
+/* Rebuild the board's accumulator from scratch */
+void NnueRefresh(struct Board* b);
+
+/* Accumulator updates for one piece entering or leaving a square */
+void NnueAddPiece(Accumulator* acc, int piece, int sq);
+void NnueSubPiece(Accumulator* acc, int piece, int sq);
+void NnueMovePiece(Accumulator* acc, int piece, int from, int to);
+
+/* Evaluation from the side to move's point of view */
+int NnueEvaluate(const struct Board* b);
+
+#ifdef DEBUG
+bool NnueCheckAccumulator(const struct Board* b); /* Incremental vs. refreshed */
+#endif
+
+#endif /* NNUE_H */
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * File: pawns.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of the pawn-structure evaluation and the pawn table.
+    - The table is thread-local and direct-mapped: a miss simply overwrites
+      the entry. An all-zero entry is the correct answer for "no pawns"
+      (pawn key 0), so the zeroed table needs no separate valid flag.
+*/
+
+#include "pawns.h"
+
+/* Bonus for a passed pawn by its relative rank (rank 2 = index 1) */
+static const int PassedMg[8] = { 0,  5, 10, 15, 25,  40,  60, 0 };
+static const int PassedEg[8] = { 0, 10, 20, 35, 60, 100, 150, 0 };
+
+#define DOUBLED_MG   10  /* Per extra pawn on a file */
+#define DOUBLED_EG   20
+#define ISOLATED_MG  10
+#define ISOLATED_EG  15
+#define BACKWARD_MG   8
+#define BACKWARD_EG  10
+
+_Thread_local PawnEntry PawnTable[PAWN_TABLE_SIZE];
+
+/* Files on either side of file f */
+static inline Bitboard AdjacentFiles(int f)
+{
+    return ((FILE_BB(f) & ~FILE_H_BB) << 1) | ((FILE_BB(f) & ~FILE_A_BB) >> 1);
+}
+
+/* Squares on the ranks strictly in front of sq, from side's point of view */
+static inline Bitboard ForwardRanks(int side, int sq)
+{
+    int rank = RANK_OF(sq);
+    if (side == WHITE) {
+        return (rank == 7) ? 0ULL : ~0ULL << (8 * (rank + 1));
+    }
+    return (1ULL << (8 * rank)) - 1;
+}
+
+/*
+    EvaluatePawns:
+    - Scores one side's pawns and fills its file mask; the caller
+      subtracts black's result from white's.
+    - A pawn is backward when no friendly pawn on an adjacent file is level
+      with or behind it and an enemy pawn guards its stop square.
+*/
+static void EvaluatePawns(const Board* b, int side, int* mg, int* eg, uint8_t* fileMask)
+{
+    Bitboard own   = b->pieceBB[MakePiece(PAWN, side)];
+    Bitboard enemy = b->pieceBB[MakePiece(PAWN, side ^ 1)];
+    int forward    = (side == WHITE) ? 8 : -8;
+
+    *mg = *eg = 0;
+    *fileMask = 0;
+
+    for (int f = 0; f < 8; f++) {
+        int count = PopCount(own & FILE_BB(f));
+        if (count) {
+            *fileMask |= (uint8_t)(1 << f);
+        }
+        if (count > 1) {
+            *mg -= DOUBLED_MG * (count - 1);
+            *eg -= DOUBLED_EG * (count - 1);
+        }
+    }
+
+    Bitboard bb = own;
+    while (bb) {
+        int sq       = PopLsb(&bb);
+        int f        = FILE_OF(sq);
+        int relRank  = (side == WHITE) ? RANK_OF(sq) : 7 - RANK_OF(sq);
+        Bitboard adj = AdjacentFiles(f);
+        Bitboard front = ForwardRanks(side, sq);
+
+        if (!(enemy & (FILE_BB(f) | adj) & front)) {
+            *mg += PassedMg[relRank];
+            *eg += PassedEg[relRank];
+        }
+
+        if (!(own & adj)) {
+            *mg -= ISOLATED_MG;
+            *eg -= ISOLATED_EG;
+        }
+        else if (!(own & adj & ~front)
+                 && (PawnAttacks[side][sq + forward] & enemy)) {
+            *mg -= BACKWARD_MG;
+            *eg -= BACKWARD_EG;
+        }
+    }
+}
+
+/*
+    ProbePawnTable:
+    - Returns the cached entry for the board's pawn key, recomputing it
+      first if the slot holds a different pawn structure.
+*/
+const PawnEntry* ProbePawnTable(const Board* b)
+{
+    PawnEntry* entry = &PawnTable[b->pawnKey & (PAWN_TABLE_SIZE - 1)];
+    if (entry->key == b->pawnKey) {
+        return entry;
+    }
+
+    int wMg, wEg, bMg, bEg;
+    EvaluatePawns(b, WHITE, &wMg, &wEg, &entry->fileMask[WHITE]);
+    EvaluatePawns(b, BLACK, &bMg, &bEg, &entry->fileMask[BLACK]);
+
+    entry->key = b->pawnKey;
+    entry->mg  = (int16_t)(wMg - bMg);
+    entry->eg  = (int16_t)(wEg - bEg);
+    return entry;
+}
@@ -0,0 +1,44 @@
+/****************************************************************************
+ * File: pawns.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the pawn-structure evaluation and its hash table.
+    - Pawn structure changes on few moves, so the pawn terms (passed,
+      isolated, doubled and backward pawns) are computed once per pawn
+      structure and cached under the board's pawn-only key.
+    - Each thread has its own table, so probes need no locking.
+*/
+
+#ifndef PAWNS_H
+#define PAWNS_H
+
+#include <stdint.h>
+#include "board.h"
+#include "misc.h"  /* For Prefetch */
+
+/* Number of pawn table entries (a power of two) */
+#define PAWN_TABLE_SIZE 16384
+
+/* Cached result for one pawn structure, scores from white's point of view */
+typedef struct {
+    uint64_t key;         /* Board pawnKey this entry was computed for */
+    int16_t mg;           /* Pawn-structure score, middle game */
+    int16_t eg;           /* Pawn-structure score, endgame */
+    uint8_t fileMask[2];  /* [side]: bit f set if the side has a pawn on file f */
+} PawnEntry;
+
+/* This thread's pawn table, direct-mapped on the low bits of pawnKey */
+extern _Thread_local PawnEntry PawnTable[PAWN_TABLE_SIZE];
+
+/* Pawn entry for the board's pawn structure, computed on a table miss */
+const PawnEntry* ProbePawnTable(const Board* b);
+
+/* Start loading this thread's pawn entry for pawnKey into the cache; inline
+   so MakeMove pays for the hint alone, not a call */
+static inline void PrefetchPawnEntry(uint64_t pawnKey)
+{
+    Prefetch(&PawnTable[pawnKey & (PAWN_TABLE_SIZE - 1)]);
+}
+
+#endif /* PAWNS_H */
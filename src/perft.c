@@ -0,0 +1,164 @@
+/****************************************************************************
+ * File: perft.c
+ ****************************************************************************/
+/*
+   Description:
+   - Implementation of perft, divide and the built-in perft suite.
+   - Moves come from GenerateLegalMoves, so the last ply is counted in
+     bulk from the size of the move list without making the moves.
+
+   Suite:
+   - Standard positions from the chess programming community (start
+     position, Kiwipete, and positions 3-6), plus endgame, en passant,
+     castling and promotion positions, with their published node counts.
+*/
+
+#include "perft.h"
+#include "movegen.h"
+#include "misc.h"
+#include <stdio.h>
+#include <inttypes.h> /* For PRIu64 */
+
+/* One suite position with its known node count at the given depth */
+typedef struct {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+} PerftPosition;
+
+static const PerftPosition PerftSuite[] = {
+    { "Start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL },
+    { "Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL },
+    { "Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083ULL },
+    { "Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL },
+    { "Position 4 (mirrored)", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 5, 15833292ULL },
+    { "Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL },
+    { "Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL },
+    { "Promotions", "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", 5, 3605103ULL },
+    { "Illegal en passant 1", "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888ULL },
+    { "Illegal en passant 2", "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133ULL },
+    { "En passant check evasion", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467ULL },
+    { "En passant discovered check", "8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1", 6, 824064ULL },
+    { "Short castling gives check", "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072ULL },
+    { "Long castling gives check", "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6, 803711ULL },
+    { "Castle rights", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206ULL },
+    { "Castling prevented", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476ULL },
+    { "Promote out of check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001ULL },
+    { "Discovered check", "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", 5, 1004658ULL },
+    { "Promote to give check", "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6, 217342ULL },
+    { "Under-promote to give check", "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683ULL },
+    { "Self stalemate", "K1k5/8/P7/8/8/8/8/8 w - - 0 1", 6, 2217ULL },
+    { "Stalemate and checkmate", "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584ULL },
+    { "Double check", "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527ULL },
+};
+
+/*
+    Perft:
+    - Recursively counts the legal leaf nodes at the given depth.
+*/
+uint64_t Perft(Board* b, int depth)
+{
+    if (depth == 0) {
+        return 1ULL;
+    }
+
+    Move moveList[MAX_POSITION_MOVES];
+    int moveCount = GenerateLegalMoves(b, moveList);
+    if (depth == 1) {
+        return (uint64_t)moveCount; /* Bulk count: the list is exactly legal */
+    }
+
+    uint64_t nodes = 0ULL;
+    for (int i = 0; i < moveCount; i++) {
+        MakeMove(b, moveList[i]);
+        nodes += Perft(b, depth - 1);
+        UnmakeMove(b);
+    }
+
+    return nodes;
+}
+
+/* Prints the nodes / time / NPS summary line */
+static void PrintPerftStats(uint64_t nodes, int64_t elapsed)
+{
+    uint64_t nps = (elapsed > 0) ? nodes * 1000ULL / (uint64_t)elapsed : 0ULL;
+    printf("Nodes: %" PRIu64 "  Time: %" PRId64 " ms  NPS: %" PRIu64 "\n", nodes, elapsed, nps);
+}
+
+/*
+    PerftCommand:
+    - Runs perft (or divide) on the current board and reports throughput.
+*/
+void PerftCommand(Board* b, int depth, bool divide)
+{
+    if (depth < 1) {
+        printf("Perft depth must be at least 1\n");
+        return;
+    }
+
+    int64_t start = GetTimeMs();
+    uint64_t nodes = 0ULL;
+
+    if (divide) {
+        Move moveList[MAX_POSITION_MOVES];
+        int moveCount = GenerateLegalMoves(b, moveList);
+
+        for (int i = 0; i < moveCount; i++) {
+            MakeMove(b, moveList[i]);
+            uint64_t count = Perft(b, depth - 1);
+            UnmakeMove(b);
+
+            char uci[8];
+            MoveToUciMove(moveList[i], uci);
+            printf("%s: %" PRIu64 "\n", uci, count);
+            nodes += count;
+        }
+        printf("\n");
+    }
+    else {
+        nodes = Perft(b, depth);
+    }
+
+    PrintPerftStats(nodes, GetTimeMs() - start);
+    fflush(stdout);
+}
+
+/*
+    RunPerftSuite:
+    - Runs every suite position at its reference depth and compares the
+      node count. Prints one line per position plus an overall summary.
+*/
+int RunPerftSuite(void)
+{
+    static Board board; /* static: Board carries a large undo stack */
+    int count = (int)(sizeof(PerftSuite) / sizeof(PerftSuite[0]));
+    int failures = 0;
+    uint64_t totalNodes = 0ULL;
+    int64_t totalTime = 0;
+
+    for (int i = 0; i < count; i++) {
+        const PerftPosition* pos = &PerftSuite[i];
+        SetFen(&board, pos->fen, false);
+
+        int64_t start = GetTimeMs();
+        uint64_t nodes = Perft(&board, pos->depth);
+        int64_t elapsed = GetTimeMs() - start;
+
+        bool ok = (nodes == pos->nodes);
+        if (!ok) failures++;
+        totalNodes += nodes;
+        totalTime  += elapsed;
+
+        printf("%2d/%d %-28s depth %d: %12" PRIu64 " %s (expected %" PRIu64 ") %" PRId64 " ms\n",
+               i + 1, count, pos->name, pos->depth, nodes,
+               ok ? "OK  " : "FAIL", pos->nodes, elapsed);
+        fflush(stdout);
+    }
+
+    printf("\n%d/%d positions passed\n", count - failures, count);
+    PrintPerftStats(totalNodes, totalTime);
+    fflush(stdout);
+
+    return failures;
+}
@@ -0,0 +1,39 @@
+/****************************************************************************
+ * File: perft.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for perft (performance test) move-path enumeration.
+    - Counts the leaf nodes of the legal move tree to a fixed depth, which
+      validates move generation and make/unmake against known node counts
+      and measures their raw throughput.
+
+    Exports:
+      1) uint64_t Perft(Board* b, int depth);
+      2) void     PerftCommand(Board* b, int depth, bool divide);
+      3) int      RunPerftSuite(void);
+*/
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+
+/* Count leaf nodes of the legal move tree to the given depth. */
+uint64_t Perft(Board* b, int depth);
+
+/*
+   Run perft on b and print nodes, elapsed time and nodes per second.
+   With divide = true, the node count below each root move is printed too.
+*/
+void PerftCommand(Board* b, int depth, bool divide);
+
+/*
+   Run the built-in suite of standard positions with known node counts.
+   Returns the number of positions whose count did not match.
+*/
+int RunPerftSuite(void);
+
+#endif /* PERFT_H */
@@ -4,10 +4,122 @@
 /*
     Implementation of the primary search algorithm.
     Includes Alpha-Beta pruning and Quiescence search.
+
+    Lazy SMP:
+    - SearchPosition starts info->threads - 1 helper threads. Each one runs
+      the same iterative deepening on its own copy of the board; they only
+      cooperate through the shared transposition table.
+    - Helpers with an odd id start one ply deeper, so the threads spread
+      over different depths instead of repeating each other.
+    - When the main thread is done it raises the stop signal, joins the
+      helpers and picks the final move by a depth- and score-weighted vote.
+
+    Background search:
+    - StartSearch copies the root position and limits and runs the search
+      on its own thread, which prints "bestmove" when it is done.
+    - StopSearch only sets an atomic flag; the main search thread sees it
+      within CHECK_NODES nodes and raises the stop signal for the helpers.
 */
 
 #include "search.h"
-#include <time.h>
+#include "movepicker.h"
+#include "see.h"
+#include "pawns.h"
+#include "syzygy.h"
+#include "timeman.h"
+#include "misc.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_NODES 2048                /* Nodes between stop/time checks (power of 2) */
+#define MATE_BOUND  (MATE - MAX_DEPTH)  /* Scores beyond this are mate scores */
+#define TB_WIN      (MATE_BOUND - 1)    /* Tablebase win at the root, minus ply */
+#define TB_BOUND    (TB_WIN - MAX_DEPTH) /* Scores beyond this are TB wins or mates */
+#define ASPIRATION_DEPTH 5                /* First depth searched with a window */
+#define ASPIRATION_DELTA 25               /* Initial half-width of the window */
+#define MAX_HISTORY      16384            /* History scores stay within +-MAX_HISTORY */
+#define DELTA_MARGIN     200              /* Qsearch: safety margin for delta pruning */
+#define RFP_DEPTH        6                /* Reverse futility pruning up to this depth */
+#define RFP_MARGIN       80               /* ... with this margin per ply */
+#define NMP_DEPTH        3                /* Null-move pruning from this depth */
+#define FUTILITY_DEPTH   3                /* Futility pruning up to this depth */
+#define LMR_DEPTH        3                /* Late move reductions from this depth */
+#define LMR_MOVES        3                /* ... for moves after this many */
+
+/* Futility margins by remaining depth */
+static const int FutilityMargin[FUTILITY_DEPTH + 1] = { 0, 200, 300, 500 };
+
+/* Late move reduction by [depth][move number], filled by InitSearch */
+static int Reductions[MAX_DEPTH][MAX_POSITION_MOVES];
+
+/* One helper thread: private board and search state */
+typedef struct {
+    Board board;
+    SearchInfo info;
+    pthread_t handle;
+} HelperThread;
+
+/*
+   The threads of one SearchPosition call. It lives on that call's stack
+   and every thread's SearchInfo points to it, so independent searches can
+   run side by side (e.g. the EPD analysis workers).
+*/
+struct ThreadGroup {
+    atomic_bool stop;       /* Raised by the main thread to stop all helpers */
+    HelperThread* helpers;  /* For node totals in the info output */
+    int numHelpers;
+};
+
+/* Set by StopSearch ("stop" from the GUI), read by the main search thread */
+static atomic_bool StopRequested;
+
+/* Raised by StartSearch for "go ponder", lowered by PonderHit */
+static atomic_bool Pondering;
+
+/* Background search thread; only the UCI thread touches these */
+static pthread_t SearchThread;
+static bool SearchRunning = false;
+static Board RootBoard;
+static SearchInfo RootInfo;
+
+/*
+   Natural logarithm of x >= 1 for the reduction table. (<math.h> is kept
+   out of the search: its INFINITY would replace the engine's.)
+   x = m * 2^e with m in [1, 2), and ln m = 2 * atanh((m - 1) / (m + 1)).
+*/
+static double Ln(double x)
+{
+    int e = 0;
+    while (x >= 2.0) {
+        x /= 2.0;
+        e++;
+    }
+
+    double z = (x - 1.0) / (x + 1.0);
+    double term = z, sum = 0.0;
+    for (int k = 1; k < 40; k += 2) {
+        sum  += term / k;
+        term *= z * z;
+    }
+    return e * 0.69314718055994531 + 2.0 * sum;
+}
+
+/*
+    InitSearch:
+    - Fills the reduction table: ln(depth) * ln(moveNumber) / 2.25, so
+      reductions grow slowly with both. Must be called once before searching.
+*/
+void InitSearch(void)
+{
+    for (int depth = 1; depth < MAX_DEPTH; depth++) {
+        for (int moves = 1; moves < MAX_POSITION_MOVES; moves++) {
+            Reductions[depth][moves] = (int)(0.75 + Ln(depth) * Ln(moves) / 2.25);
+        }
+    }
+}
 
 /*
     ClearSearchInfo:
@@ -15,99 +127,1215 @@
 */
 void ClearSearchInfo(SearchInfo* info)
 {
-    info->depth     = 0;
-    info->movetime  = 0;
-    info->startTime = 0;
-    info->stopTime  = 0;
-    info->nodes     = 0;
-    info->timeSet   = false;
-    info->stopped   = false;
-    info->bestMove.from     = 0;
-    info->bestMove.to       = 0;
-    info->bestMove.captured = 0;
-    info->bestMove.promoted = 0;
-    info->bestMove.flag     = 0;
+    info->depth          = 0;
+    info->movetime       = 0;
+    info->timeLeft       = 0;
+    info->increment      = 0;
+    info->movesToGo      = 0;
+    info->startTime      = 0;
+    info->clockStart     = 0;
+    info->softStopTime   = 0;
+    info->stopTime       = 0;
+    info->stableIterations = 0;
+    info->nodes          = 0;
+    info->nodeLimit      = 0;
+    info->timeSet        = false;
+    info->infinite       = false;
+    info->ponder         = false;
+    info->stopped        = false;
+    info->multiPV        = 1;
+    info->pvIdx          = 0;
+    info->searchMoveCount = 0;
+    info->rootMoveCount  = 0;
+    info->bestMove       = NOMOVE;
+    info->ponderMove     = NOMOVE;
+    info->bestScore      = 0;
+    info->completedDepth = 0;
+    info->threads        = 1;
+    info->threadId       = 0;
+    info->tt             = NULL;
+    info->group          = NULL;
+    info->report         = true;
+    info->nullMove       = true;
+    info->lmr            = true;
+    info->futility       = true;
+    info->checkExtensions = true;
+    info->tbPieces       = 0;
+    info->tbHits         = 0;
+    info->pvLength[0]    = 0;
+    memset(info->killers, 0, sizeof(info->killers));
+    memset(info->history, 0, sizeof(info->history));
+    memset(&info->stats, 0, sizeof(info->stats));
+}
+
+/* Static evaluation from the side to move's point of view */
+static int EvaluateSide(const Board* b, SearchInfo* info)
+{
+    STAT_INC(&info->stats, evalCalls);
+    int score = EvaluatePosition(b);
+    return (b->side == WHITE) ? score : -score;
+}
+
+static bool InCheck(const Board* b)
+{
+    return IsSquareAttacked(b, KingSquare(b, b->side), b->side ^ 1);
+}
+
+/* Whether side has a piece other than pawns and the king (null-move guard) */
+static bool HasNonPawnMaterial(const Board* b, int side)
+{
+    return (b->colorBB[side] & ~(b->pieceBB[MakePiece(PAWN, side)]
+                                 | b->pieceBB[MakePiece(KING, side)])) != 0;
+}
+
+/*
+    IsDraw:
+    - Fifty-move rule, or the position already occurred since the last
+      irreversible or null move (same side to move, so every second entry).
+*/
+static bool IsDraw(const Board* b)
+{
+    if (b->fiftyMove >= 100) {
+        return true;
+    }
+
+    /* A repetition needs no irreversible move and no null move in between */
+    int reversible = (b->fiftyMove < b->pliesFromNull) ? b->fiftyMove : b->pliesFromNull;
+    int first = b->hisPly - reversible;
+    if (first < 0) first = 0;
+    for (int i = b->hisPly - 2; i >= first; i -= 2) {
+        if (b->history[i].posKey == b->posKey) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Mate and tablebase scores are stored relative to the node, not to the root */
+static int ScoreToTT(int score, int ply)
+{
+    if (score > TB_BOUND)  return score + ply;
+    if (score < -TB_BOUND) return score - ply;
+    return score;
+}
+
+static int ScoreFromTT(int score, int ply)
+{
+    if (score > TB_BOUND)  return score - ply;
+    if (score < -TB_BOUND) return score + ply;
+    return score;
+}
+
+/* Score of a WDL result at ply; the fifty-move rule makes cursed wins and
+   blessed losses draws */
+static int TbScore(int wdl, int ply)
+{
+    if (wdl == WDL_WIN)  return TB_WIN - ply;
+    if (wdl == WDL_LOSS) return -TB_WIN + ply;
+    return 0;
+}
+
+/*
+    UpdateHistory:
+    - Moves a history score towards +-MAX_HISTORY by bonus; the closer it
+      already is, the smaller the step, so scores never overflow and old
+      information fades as new cutoffs come in.
+*/
+static void UpdateHistory(SearchInfo* info, const Board* b, Move move, int bonus)
+{
+    int* entry = &info->history[b->pieces[FromSq(move)]][ToSq(move)];
+    *entry += bonus - *entry * abs(bonus) / MAX_HISTORY;
+}
+
+/*
+    UpdateQuietStats:
+    - A quiet move caused a beta cutoff: make it the first killer of this
+      ply, reward it in the history table and penalise the quiet moves
+      searched before it without success.
+*/
+static void UpdateQuietStats(SearchInfo* info, const Board* b, Move best,
+                             const Move* quiets, int quietCount, int depth)
+{
+    int ply = b->ply;
+    if (info->killers[ply][0] != best) {
+        info->killers[ply][1] = info->killers[ply][0];
+        info->killers[ply][0] = best;
+    }
+
+    int bonus = depth * depth;
+    if (bonus > MAX_HISTORY / 4) bonus = MAX_HISTORY / 4;
+    UpdateHistory(info, b, best, bonus);
+    for (int i = 0; i < quietCount; i++) {
+        if (quiets[i] != best) {
+            UpdateHistory(info, b, quiets[i], -bonus);
+        }
+    }
+}
+
+/*
+    CheckPonderHit:
+    - Main thread only. Once the GUI has sent "ponderhit" the search goes
+      on as a normal one: the time budget is worked out afresh from now,
+      as our clock only started running at the ponderhit.
+*/
+static void CheckPonderHit(SearchInfo* info)
+{
+    if (info->ponder && !atomic_load_explicit(&Pondering, memory_order_relaxed)) {
+        info->ponder     = false;
+        info->clockStart = GetTimeMs();
+        InitTimeManager(info);
+    }
+}
+
+/*
+    CheckUp:
+    - Called every CHECK_NODES nodes, and exactly at the node limit.
+    - Every thread follows the shared stop signal; only the main thread
+      looks at the clock (not while pondering), its node limit and the
+      GUI's stop request, and raises the signal.
+*/
+static void CheckUp(SearchInfo* info)
+{
+    if (info->threadId == 0) {
+        CheckPonderHit(info);
+    }
+
+    if (atomic_load_explicit(&info->group->stop, memory_order_relaxed)) {
+        info->stopped = true;
+    }
+    else if (info->threadId == 0
+             && (atomic_load_explicit(&StopRequested, memory_order_relaxed)
+                 || (info->timeSet && !info->ponder && GetTimeMs() >= info->stopTime)
+                 || (info->nodeLimit && info->nodes >= info->nodeLimit))) {
+        info->stopped = true;
+        atomic_store(&info->group->stop, true);
+    }
+}
+
+/*
+   A thread's node and tablebase-hit counters are read by the main thread
+   while it searches (TotalNodes, TotalTbHits). Only the owner writes them,
+   so it reads them plainly and publishes each increment with a relaxed
+   atomic store: race-free, and as cheap as a plain increment.
+*/
+static inline void CountNode(SearchInfo* info)
+{
+    __atomic_store_n(&info->nodes, info->nodes + 1, __ATOMIC_RELAXED);
+}
+
+static inline void CountTbHit(SearchInfo* info)
+{
+    __atomic_store_n(&info->tbHits, info->tbHits + 1, __ATOMIC_RELAXED);
+}
+
+/* Nodes searched so far by all threads */
+static uint64_t TotalNodes(const SearchInfo* info)
+{
+    uint64_t nodes = info->nodes;
+    for (int i = 0; i < info->group->numHelpers; i++) {
+        nodes += __atomic_load_n(&info->group->helpers[i].info.nodes, __ATOMIC_RELAXED);
+    }
+    return nodes;
+}
+
+/* Tablebase hits so far by all threads */
+static uint64_t TotalTbHits(const SearchInfo* info)
+{
+    uint64_t hits = info->tbHits;
+    for (int i = 0; i < info->group->numHelpers; i++) {
+        hits += __atomic_load_n(&info->group->helpers[i].info.tbHits, __ATOMIC_RELAXED);
+    }
+    return hits;
+}
+
+/*
+    PrefetchChild:
+    - Called right after MakeMove: starts the memory loads the child node
+      will need, its TT bucket (only full-width nodes probe the TT) and,
+      for the classical evaluation, its pawn entry.
+*/
+static inline void PrefetchChild(const Board* b, const SearchInfo* info, int depth)
+{
+    if (depth > 0) {
+        PrefetchHashEntry(info->tt, b->posKey);
+    }
+    if (!NnueEnabled) {
+        PrefetchPawnEntry(b->pawnKey);
+    }
+}
+
+/* Prints a UCI score: centipawns, or moves to mate */
+static void PrintScore(int score)
+{
+    if (score > MATE_BOUND) {
+        printf("score mate %d", (MATE - score + 1) / 2);
+    }
+    else if (score < -MATE_BOUND) {
+        printf("score mate %d", -(MATE + score) / 2);
+    }
+    else {
+        printf("score cp %d", score);
+    }
+}
+
+/* Prints the "info" lines (one per MultiPV line) for a finished iteration
+   of the main thread */
+static void ReportIteration(const SearchInfo* info, int depth, int lines)
+{
+    int64_t elapsed = GetTimeMs() - info->startTime;
+    uint64_t nodes  = TotalNodes(info);
+    uint64_t nps    = (elapsed > 0) ? nodes * 1000 / (uint64_t)elapsed : nodes;
+
+    for (int line = 0; line < lines; line++) {
+        const RootMove* rm = &info->rootMoves[line];
+
+        printf("info depth %d multipv %d ", depth, line + 1);
+        PrintScore(rm->score);
+        printf(" nodes %llu nps %llu hashfull %d tbhits %llu time %lld pv",
+               (unsigned long long)nodes, (unsigned long long)nps, HashFull(info->tt),
+               (unsigned long long)TotalTbHits(info), (long long)elapsed);
+
+        for (int i = 0; i < rm->pvLength; i++) {
+            char moveStr[6];
+            MoveToUciMove(rm->pv[i], moveStr);
+            printf(" %s", moveStr);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+/* Stable insertion sort by score, best first (moves keep their order on ties) */
+static void SortRootMoves(RootMove* moves, int count)
+{
+    for (int i = 1; i < count; i++) {
+        RootMove rm = moves[i];
+        int j = i - 1;
+        while (j >= 0 && moves[j].score < rm.score) {
+            moves[j + 1] = moves[j];
+            j--;
+        }
+        moves[j + 1] = rm;
+    }
+}
+
+/*
+    InitRootMoves:
+    - Builds info->rootMoves in move picker order (TT move first), keeping
+      only the "go searchmoves" moves when that list names any legal move.
+*/
+static void InitRootMoves(const Board* b, SearchInfo* info)
+{
+    Move ttMove = NOMOVE;
+    int ttScore, ttFlag;
+    ProbeHashEntry(info->tt, b->posKey, 0, &ttScore, &ttFlag, &ttMove);
+
+    for (int pass = 0; pass < 2; pass++) {
+        bool filter = (pass == 0 && info->searchMoveCount > 0);
+        MovePicker mp;
+        InitMovePicker(&mp, b, ttMove, NULL, (const int (*)[BOARD_SIZE])info->history);
+
+        info->rootMoveCount = 0;
+        Move move;
+        while ((move = NextMove(&mp)) != NOMOVE) {
+            if (filter) {
+                bool listed = false;
+                for (int i = 0; i < info->searchMoveCount && !listed; i++) {
+                    listed = (info->searchMoves[i] == move);
+                }
+                if (!listed) {
+                    continue;
+                }
+            }
+            RootMove* rm  = &info->rootMoves[info->rootMoveCount++];
+            rm->move      = move;
+            rm->score     = -INFINITY;
+            rm->prevScore = -INFINITY;
+            rm->pvLength  = 1;
+            rm->pv[0]     = move;
+        }
+        if (info->rootMoveCount > 0 || !filter) {
+            break;
+        }
+        info->searchMoveCount = 0;  /* None of them legal: search everything */
+    }
+}
+
+/*
+    TbRankRootMoves:
+    - Probes the root moves (searchmoves already applied) and sorts them
+      by tablebase result: wins before draws before losses, the quickest
+      conversion first among wins and the slowest among losses.
+    - Each move gets the score of its WDL result and a one-move PV.
+      Fails, leaving the list untouched, if any move isn't in the tables.
+*/
+static bool TbRankRootMoves(const Board* b, SearchInfo* info)
+{
+    Move moves[MAX_POSITION_MOVES];
+    int wdl[MAX_POSITION_MOVES];
+    int dtz[MAX_POSITION_MOVES];
+    int count = info->rootMoveCount;
+
+    for (int i = 0; i < count; i++) {
+        moves[i] = info->rootMoves[i].move;
+    }
+    if (!TbProbeRoot(b, moves, count, wdl, dtz)) {
+        return false;
+    }
+
+    /* Sort on a rank held in score, keeping the real score in prevScore */
+    for (int i = 0; i < count; i++) {
+        RootMove* rm = &info->rootMoves[i];
+        int rank = wdl[i] * 8192;
+        if (wdl[i] > 0) rank -= dtz[i];
+        if (wdl[i] < 0) rank += dtz[i];
+        rm->score     = rank;
+        rm->prevScore = TbScore(wdl[i], 0);
+        rm->pvLength  = 1;
+        rm->pv[0]     = rm->move;
+    }
+    SortRootMoves(info->rootMoves, count);
+    for (int i = 0; i < count; i++) {
+        info->rootMoves[i].score = info->rootMoves[i].prevScore;
+    }
+    return true;
+}
+
+/*
+    SearchRoot:
+    - The root node of the alpha-beta search. It walks info->rootMoves
+      from info->pvIdx on, in the order the last search left them, so the
+      MultiPV lines already found this iteration are excluded and each new
+      line is the best of the remaining moves.
+    - A move that raises alpha gets its score and PV; every other move is
+      marked -INFINITY, so the stable sort afterwards keeps its old place.
+    - Otherwise a PV node of AlphaBeta: same reductions and history and
+      killer updates, but no pruning and no TT cutoff.
+    - Results over a partial move list (later MultiPV lines, searchmoves)
+      only go to the TT when they are valid for the whole position: as a
+      lower bound after a beta cutoff.
+*/
+static int SearchRoot(Board* b, int alpha, int beta, int depth, SearchInfo* info)
+{
+    bool fullList = (info->pvIdx == 0 && info->searchMoveCount == 0);
+    info->pvLength[0] = 0;
+
+    if (InCheck(b) && info->checkExtensions) {
+        depth++;
+    }
+    if ((info->nodes & (CHECK_NODES - 1)) == 0 || info->nodes == info->nodeLimit) {
+        CheckUp(info);
+    }
+    CountNode(info);
+    if (info->stopped) {
+        return 0;
+    }
+
+    for (int i = info->pvIdx; i < info->rootMoveCount; i++) {
+        info->rootMoves[i].score = -INFINITY;
+    }
+
+    bool inCheck = InCheck(b);
+    int oldAlpha = alpha;
+    Move bestMove = NOMOVE;
+    Move quiets[MAX_POSITION_MOVES];
+    int quietCount = 0;
+
+    for (int i = info->pvIdx; i < info->rootMoveCount; i++) {
+        RootMove* rm = &info->rootMoves[i];
+        Move move = rm->move;
+        int legalMoves = i - info->pvIdx + 1;
+        bool quiet = !IsCapture(move) && !IsPromotion(move);
+        int histScore = info->history[b->pieces[FromSq(move)]][ToSq(move)];
+        int score;
+
+        MakeMove(b, move);
+        bool givesCheck = InCheck(b);
+        PrefetchChild(b, info, depth - 1);
+
+        if (legalMoves == 1) {
+            score = -AlphaBeta(b, -beta, -alpha, depth - 1, info);
+        }
+        else {
+            /* Late move reductions as in AlphaBeta for a PV node */
+            int r = 0;
+            if (info->lmr && depth >= LMR_DEPTH && legalMoves > LMR_MOVES && quiet
+                && !inCheck && !givesCheck
+                && move != info->killers[0][0] && move != info->killers[0][1]) {
+                r = Reductions[depth < MAX_DEPTH ? depth : MAX_DEPTH - 1]
+                              [legalMoves < MAX_POSITION_MOVES ? legalMoves : MAX_POSITION_MOVES - 1];
+                r--;
+                r -= histScore / (MAX_HISTORY / 2);
+                if (r > depth - 2) r = depth - 2;
+                if (r < 0) r = 0;
+            }
+
+            score = -AlphaBeta(b, -alpha - 1, -alpha, depth - 1 - r, info);
+            if (r > 0 && score > alpha) {
+                score = -AlphaBeta(b, -alpha - 1, -alpha, depth - 1, info);
+            }
+            if (score > alpha && score < beta) {
+                score = -AlphaBeta(b, -beta, -alpha, depth - 1, info);
+            }
+        }
+        UnmakeMove(b);
+
+        if (info->stopped) {
+            return 0;
+        }
+
+        if (score > alpha) {
+            bestMove     = move;
+            rm->score    = score;
+            rm->pv[0]    = move;
+            memcpy(&rm->pv[1], info->pv[1], info->pvLength[1] * sizeof(Move));
+            rm->pvLength = info->pvLength[1] + 1;
+
+            if (score >= beta) {
+                STAT_INC(&info->stats, failHighs);
+                if (legalMoves == 1) {
+                    STAT_INC(&info->stats, failHighFirst);
+                }
+                if (!IsCapture(move)) {
+                    UpdateQuietStats(info, b, move, quiets, quietCount, depth);
+                }
+                StoreHashEntry(info->tt, b->posKey, depth, ScoreToTT(beta, 0), TT_BETA, bestMove);
+                return beta;
+            }
+            alpha = score;
+        }
+        if (!IsCapture(move)) {
+            quiets[quietCount++] = move;
+        }
+    }
+
+    if (fullList) {
+        StoreHashEntry(info->tt, b->posKey, depth, ScoreToTT(alpha, 0),
+                       (alpha > oldAlpha) ? TT_EXACT : TT_ALPHA, bestMove);
+    }
+    return alpha;
+}
+
+/*
+    AspirationSearch:
+    - Searches the root with a narrow window around the previous score.
+    - On a fail low or high the window is widened on that side (doubling
+      each time) until the score lands inside it; once the window grows
+      past a rook either way, or the score is a mate, it opens fully.
+    - The unsettled root moves are re-sorted after every root search, so
+      a re-search starts with the move that just failed high.
+*/
+static int AspirationSearch(Board* b, int depth, int prevScore, SearchInfo* info)
+{
+    RootMove* unsettled = info->rootMoves + info->pvIdx;
+    int unsettledCount  = info->rootMoveCount - info->pvIdx;
+
+    if (depth < ASPIRATION_DEPTH || prevScore > MATE_BOUND || prevScore < -MATE_BOUND) {
+        int score = SearchRoot(b, -INFINITY, INFINITY, depth, info);
+        if (!info->stopped) {
+            SortRootMoves(unsettled, unsettledCount);
+        }
+        return score;
+    }
+
+    int delta = ASPIRATION_DELTA;
+    int alpha = prevScore - delta;
+    int beta  = prevScore + delta;
+
+    while (true) {
+        int score = SearchRoot(b, alpha, beta, depth, info);
+        if (info->stopped) {
+            return 0;
+        }
+        SortRootMoves(unsettled, unsettledCount);
+
+        if (score <= alpha) {
+            alpha = (delta > VAL_ROOK) ? -INFINITY : score - delta;
+        }
+        else if (score >= beta) {
+            beta = (delta > VAL_ROOK) ? INFINITY : score + delta;
+        }
+        else {
+            return score;
+        }
+        delta *= 2;
+    }
+}
+
+/*
+    IterativeDeepening:
+    - Searches depth 1, 2, ... up to info->depth until stopped.
+    - Each iteration searches the MultiPV lines in turn: line k is the best
+      root move once lines 0..k-1 are excluded, with an aspiration window
+      around that move's score from the previous iteration.
+    - An iteration cut short by a stop is discarded; bestMove, bestScore and
+      completedDepth always describe the last full iteration.
+    - The main thread asks the time manager after every iteration whether
+      the next one is worth starting. On a clock it also stops at once with
+      a single legal move, or when a short forced mate has been found.
+      None of this applies while pondering, which runs until "ponderhit"
+      or "stop".
+*/
+static void IterativeDeepening(Board* b, SearchInfo* info)
+{
+    int startDepth = 1 + (info->threadId & 1);
+    int lines = (info->multiPV < info->rootMoveCount) ? info->multiPV : info->rootMoveCount;
+    bool onlyMove = info->rootMoveCount == 1;
+
+    for (int depth = startDepth; depth <= info->depth; depth++) {
+        for (int i = 0; i < info->rootMoveCount; i++) {
+            info->rootMoves[i].prevScore = info->rootMoves[i].score;
+        }
+
+        for (info->pvIdx = 0; info->pvIdx < lines; info->pvIdx++) {
+            AspirationSearch(b, depth, info->rootMoves[info->pvIdx].prevScore, info);
+            if (info->stopped) {
+                break;
+            }
+            SortRootMoves(info->rootMoves, info->pvIdx + 1);
+        }
+        if (info->stopped) {
+            break;
+        }
+
+        Move previous = info->bestMove;
+        info->completedDepth = depth;
+        info->bestScore      = info->rootMoves[0].score;
+        info->bestMove       = info->rootMoves[0].move;
+
+        if (info->threadId == 0) {
+            if (info->report) {
+                ReportIteration(info, depth, lines);
+            }
+            /* While pondering, the clock decides nothing */
+            CheckPonderHit(info);
+            if (info->ponder) {
+                continue;
+            }
+            if (StopAfterIteration(info, info->bestMove != previous)
+                || (onlyMove && info->timeSet && info->movetime == 0)) {
+                break;
+            }
+            /* A forced mate found this shallow won't change with more depth */
+            int mateDist = MATE - abs(info->bestScore);
+            if (info->timeSet && mateDist < MAX_DEPTH && depth >= 2 * mateDist + 2) {
+                break;
+            }
+        }
+    }
+}
+
+static void* HelperMain(void* arg)
+{
+    HelperThread* helper = (HelperThread*)arg;
+    IterativeDeepening(&helper->board, &helper->info);
+    return NULL;
+}
+
+/*
+    VoteBestMove:
+    - Each thread votes for its move with weight (score - worst score + 14)
+      times its completed depth, so deep and confident threads count most.
+    - Returns the thread whose move collected the most votes; on a tie the
+      main thread (index 0) wins.
+*/
+static const SearchInfo* VoteBestMove(const SearchInfo** infos, int count)
+{
+    int minScore = INFINITY;
+    for (int i = 0; i < count; i++) {
+        if (infos[i]->bestMove != NOMOVE && infos[i]->bestScore < minScore) {
+            minScore = infos[i]->bestScore;
+        }
+    }
+
+    const SearchInfo* best = infos[0];
+    int64_t bestVotes = -1;
+    for (int i = 0; i < count; i++) {
+        if (infos[i]->bestMove == NOMOVE) continue;
+
+        int64_t votes = 0;
+        for (int j = 0; j < count; j++) {
+            if (infos[j]->bestMove == infos[i]->bestMove) {
+                votes += (int64_t)(infos[j]->bestScore - minScore + 14) * infos[j]->completedDepth;
+            }
+        }
+        if (votes > bestVotes) {
+            bestVotes = votes;
+            best      = infos[i];
+        }
+    }
+    return best;
+}
+
+/*
+    ExpectedReply:
+    - The move to ponder on after best->bestMove: the second move of the
+      PV that chose it, or else the TT move of the position after it.
+*/
+static Move ExpectedReply(Board* b, const SearchInfo* best)
+{
+    Move move = best->bestMove;
+    if (move == NOMOVE) {
+        return NOMOVE;
+    }
+
+    const RootMove* rm = &best->rootMoves[0];
+    if (rm->move == move && rm->pvLength > 1) {
+        return rm->pv[1];
+    }
+
+    Move reply = NOMOVE;
+    int ttScore, ttFlag;
+    MakeMove(b, move);
+    ProbeHashEntry(best->tt, b->posKey, 0, &ttScore, &ttFlag, &reply);
+    if (reply != NOMOVE && !IsMoveLegal(b, reply)) {
+        reply = NOMOVE;
+    }
+    UnmakeMove(b);
+    return reply;
 }
 
 /*
     SearchPosition:
     - The main entry point for searching the best move.
-    - Handles iterative deepening and time management.
+    - Sets up the limits, starts the helper threads, runs iterative
+      deepening on this thread, then stops and joins the helpers.
+    - On return info->bestMove/bestScore hold the voted result,
+      info->ponderMove the expected reply and info->nodes the node count
+      of all threads.
 */
 int SearchPosition(Board* b, SearchInfo* info)
 {
-    /* 
-        Pseudocode for iterative deepening:
-        for (int d = 1; d <= info->depth; d++) {
-            if(info->stopped) break;
-            int score = AlphaBeta(b, -INFINITY, INFINITY, d, info);
-            // Update bestMove based on search results
+    b->ply = 0;
+
+    info->startTime  = GetTimeMs();
+    info->clockStart = info->startTime;
+    InitTimeManager(info);
+    if (info->depth <= 0 || info->depth > MAX_DEPTH - 1) {
+        info->depth = MAX_DEPTH - 1;
+    }
+    info->threadId       = 0;
+    info->nodes          = 0;
+    info->tbHits         = 0;
+    info->stopped        = false;
+    info->bestMove       = NOMOVE;
+    info->ponderMove     = NOMOVE;
+    info->bestScore      = 0;
+    info->completedDepth = 0;
+    memset(&info->stats, 0, sizeof(info->stats));
+
+    struct ThreadGroup group;
+    atomic_init(&group.stop, false);
+    group.helpers    = NULL;
+    group.numHelpers = 0;
+    info->group      = &group;
+    IncrementTTAge(info->tt);
+
+    InitRootMoves(b, info);
+    if (info->rootMoveCount == 0) {
+        info->bestScore = InCheck(b) ? -MATE : 0;
+        info->group     = NULL;
+        return info->bestScore;
+    }
+
+    /* A root position in the tablebases: play the DTZ-optimal move, which
+       converts a won position without running into the fifty-move rule */
+    if (info->tbPieces && PopCount(b->colorBB[BOTH]) <= info->tbPieces
+        && TbRankRootMoves(b, info)) {
+        int lines = info->multiPV < info->rootMoveCount ? info->multiPV : info->rootMoveCount;
+
+        info->tbHits         = 1;
+        info->bestMove       = info->rootMoves[0].move;
+        info->bestScore      = info->rootMoves[0].score;
+        info->completedDepth = 1;
+        if (info->report) {
+            ReportIteration(info, 1, lines);
         }
-    */
-    /* Placeholder implementation */
-    return 0;
+        info->group = NULL;
+        return info->bestScore;
+    }
+
+    /* Start the helpers, each on a private copy of the root position */
+    int helpers = info->threads - 1;
+    if (helpers > MAX_THREADS - 1) helpers = MAX_THREADS - 1;
+    if (helpers < 0) helpers = 0;
+
+    HelperThread* helperThreads = helpers ? (HelperThread*)malloc(helpers * sizeof(HelperThread)) : NULL;
+    if (helpers && !helperThreads) {
+        fprintf(stderr, "Error: Unable to allocate helper threads, searching with one\n");
+        helpers = 0;
+    }
+    group.helpers = helperThreads;
+    for (int i = 0; i < helpers; i++) {
+        HelperThread* h = &helperThreads[i];
+        h->board         = *b;
+        h->info          = *info;
+        h->info.threadId = i + 1;
+        if (pthread_create(&h->handle, NULL, HelperMain, h) != 0) {
+            break;
+        }
+        group.numHelpers++;
+    }
+
+    IterativeDeepening(b, info);
+
+    atomic_store(&group.stop, true);
+    for (int i = 0; i < group.numHelpers; i++) {
+        pthread_join(helperThreads[i].handle, NULL);
+    }
+
+    /* Vote (with MultiPV the main thread's ranked lines stand), then fold
+       the helpers' node counts into the main thread's */
+    const SearchInfo* best = info;
+    if (info->multiPV == 1) {
+        const SearchInfo* infos[MAX_THREADS];
+        infos[0] = info;
+        for (int i = 0; i < group.numHelpers; i++) {
+            infos[i + 1] = &helperThreads[i].info;
+        }
+        best = VoteBestMove(infos, group.numHelpers + 1);
+        info->bestMove  = best->bestMove;
+        info->bestScore = best->bestScore;
+    }
+    info->ponderMove = ExpectedReply(b, best);
+    info->nodes      = TotalNodes(info);
+
+#ifdef SEARCH_STATS
+    for (int i = 0; i < group.numHelpers; i++) {
+        AddSearchStats(&info->stats, &helperThreads[i].info.stats);
+    }
+    if (info->report) {
+        PrintSearchStats(&info->stats, info->nodes);
+    }
+#endif
+
+    free(helperThreads);
+    info->group = NULL;
+
+    /* Stopped before depth 1 finished: still return a legal move */
+    if (info->bestMove == NOMOVE) {
+        info->bestMove = info->rootMoves[0].move;
+    }
+
+    return info->bestScore;
+}
+
+/*
+    SearchThreadMain:
+    - Body of the background search thread: searches RootBoard, holds the
+      result of an infinite or ponder search until the GUI says "stop" (or
+      "ponderhit"), prints the move and the reply to ponder on.
+*/
+static void* SearchThreadMain(void* arg)
+{
+    (void)arg;
+    SearchPosition(&RootBoard, &RootInfo);
+
+    /* The GUI expects no bestmove before "stop" or, when pondering, "ponderhit" */
+    while ((RootInfo.infinite || atomic_load(&Pondering)) && !atomic_load(&StopRequested)) {
+        SleepMs(1);
+    }
+
+    char bestMoveStr[6] = "0000"; /* UCI null move: no legal move */
+    if (RootInfo.bestMove != NOMOVE) {
+        MoveToUciMove(RootInfo.bestMove, bestMoveStr);
+    }
+    if (RootInfo.ponderMove != NOMOVE) {
+        char ponderStr[6];
+        MoveToUciMove(RootInfo.ponderMove, ponderStr);
+        printf("bestmove %s ponder %s\n", bestMoveStr, ponderStr);
+    }
+    else {
+        printf("bestmove %s\n", bestMoveStr);
+    }
+    fflush(stdout);
+    return NULL;
+}
+
+/*
+    StartSearch:
+    - Stops and joins a search that is still running, then starts a new
+      one on private copies of the root position and the limits.
+    - The copy's NNUE accumulator is rebuilt, since the board it came
+      from may predate the current net.
+    - The stop request is cleared here, before the thread exists, so a
+      "stop" that arrives right after "go" cannot be lost.
+*/
+void StartSearch(const Board* b, const SearchInfo* limits)
+{
+    StopSearch();
+    WaitForSearch();
+
+    RootBoard = *b;
+    RootInfo  = *limits;
+
+    /* The net may have been loaded or switched on since the position was set */
+    if (NnueEnabled) {
+        NnueRefresh(&RootBoard);
+    }
+    atomic_store(&StopRequested, false);
+    atomic_store(&Pondering, limits->ponder);
+
+    if (pthread_create(&SearchThread, NULL, SearchThreadMain, NULL) != 0) {
+        fprintf(stderr, "Error: Unable to start the search thread\n");
+        return;
+    }
+    SearchRunning = true;
+}
+
+/*
+    StopSearch:
+    - Requests the running search to stop; "bestmove" follows from the
+      search thread shortly after. No effect if nothing is searching.
+*/
+void StopSearch(void)
+{
+    if (SearchRunning) {
+        atomic_store(&StopRequested, true);
+    }
+}
+
+/*
+    PonderHit:
+    - The opponent played the move we are pondering on: the running search
+      carries on with its tree, history and TT, now on our clock.
+*/
+void PonderHit(void)
+{
+    atomic_store(&Pondering, false);
+}
+
+/*
+    WaitForSearch:
+    - Joins the search thread, so the caller may change shared state
+      (options, the transposition table) safely afterwards.
+*/
+void WaitForSearch(void)
+{
+    if (SearchRunning) {
+        pthread_join(SearchThread, NULL);
+        SearchRunning = false;
+        atomic_store(&StopRequested, false);
+        atomic_store(&Pondering, false);
+    }
 }
 
 /*
     AlphaBeta:
-    - Implements the Alpha-Beta pruning algorithm.
+    - Implements the Alpha-Beta pruning algorithm (fail-hard negamax) as a
+      principal variation search: the first move gets the full window, the
+      rest a null window around alpha, re-searched only if they beat it.
+    - Probes the shared TT for cutoffs in non-PV nodes below the root.
+    - Selective search, each part switchable through SearchInfo (UCI
+      options): check extensions; in non-PV nodes not in check, reverse
+      futility and null-move pruning; futility pruning of quiet moves near
+      the leaves; late move reductions for late quiet moves, smaller in PV
+      nodes and for moves with a good history.
+    - Moves come from the staged picker (TT move, captures, killers, then
+      quiets by history); quiet cutoffs feed the killers and history.
+    - Keeps the principal variation in info->pv[ply].
 */
 int AlphaBeta(Board* b, int alpha, int beta, int depth, SearchInfo* info)
 {
-    /* 
-        Pseudocode:
-        if (depth == 0) {
-            return Quiescence(b, alpha, beta, info);
+    int ply = b->ply;
+    bool pvNode = (beta - alpha > 1);
+    info->pvLength[ply] = 0;
+
+    /* Check extension: a side in check is never dropped into quiescence */
+    bool inCheck = InCheck(b);
+    if (inCheck && info->checkExtensions) {
+        depth++;
+    }
+
+    if (depth <= 0) {
+        return Quiescence(b, alpha, beta, info);
+    }
+
+    if ((info->nodes & (CHECK_NODES - 1)) == 0 || info->nodes == info->nodeLimit) {
+        CheckUp(info);
+    }
+    CountNode(info);
+    if (info->stopped) {
+        return 0;
+    }
+
+    if (ply > 0 && IsDraw(b)) {
+        return 0;
+    }
+    if (ply >= MAX_DEPTH - 1) {
+        return EvaluateSide(b, info);
+    }
+
+    int ttScore, ttFlag;
+    Move ttMove = NOMOVE;
+    bool ttHit = ProbeHashEntry(info->tt, b->posKey, depth, &ttScore, &ttFlag, &ttMove);
+    STAT_INC(&info->stats, ttProbes);
+    if (ttHit) {
+        STAT_INC(&info->stats, ttHits);
+    }
+    if (ttHit && !pvNode && ply > 0) {
+        ttScore = ScoreFromTT(ttScore, ply);
+        if (ttFlag == TT_EXACT) {
+            STAT_INC(&info->stats, ttCutoffs);
+            return ttScore;
         }
-        if (info->stopped) {
-            return 0;
+        if (ttFlag == TT_BETA && ttScore >= beta) {
+            STAT_INC(&info->stats, ttCutoffs);
+            return beta;
+        }
+        if (ttFlag == TT_ALPHA && ttScore <= alpha) {
+            STAT_INC(&info->stats, ttCutoffs);
+            return alpha;
         }
+    }
+
+    /* Tablebases: right after a capture or pawn move, with few pieces left,
+       the WDL result is exact. A win is only a lower bound (there may be a
+       faster mate) and a loss an upper bound, so those cut off only when
+       they fall outside the window */
+    if (ply > 0 && info->tbPieces && b->fiftyMove == 0 && !b->castlePerm
+        && PopCount(b->colorBB[BOTH]) <= info->tbPieces) {
+        int wdl;
+        if (TbProbeWdl(b, &wdl)) {
+            CountTbHit(info);
+            int score = TbScore(wdl, ply);
+            int flag  = (wdl == WDL_WIN) ? TT_BETA : (wdl == WDL_LOSS) ? TT_ALPHA : TT_EXACT;
 
-        GenerateAllMoves(b, moves);
-        if (movesCount == 0) {
-            // Checkmate or stalemate
+            if (flag == TT_EXACT || (flag == TT_BETA && score >= beta)
+                || (flag == TT_ALPHA && score <= alpha)) {
+                StoreHashEntry(info->tt, b->posKey, MAX_DEPTH - 1, ScoreToTT(score, ply),
+                               flag, NOMOVE);
+                return (flag == TT_BETA) ? beta : (flag == TT_ALPHA) ? alpha : score;
+            }
         }
+    }
 
-        for each move in moves:
-            MakeMove(b, move);
-            score = -AlphaBeta(b, -beta, -alpha, depth - 1, info);
-            UnmakeMove(b, move);
+    /* Pruning before any move is searched; never in PV nodes or in check */
+    int staticEval = -INFINITY;
+    if (!pvNode && !inCheck) {
+        staticEval = EvaluateSide(b, info);
 
+        /* Reverse futility: far enough above beta that a shallow search
+           won't bring the score back down */
+        if (info->futility && depth <= RFP_DEPTH && beta < MATE_BOUND
+            && staticEval - RFP_MARGIN * depth >= beta) {
+            return beta;
+        }
+
+        /* Null move: if passing still fails high, a real move will too.
+           Not twice in a row, and not with only pawns left, where
+           zugzwang makes passing the better "move" */
+        if (info->nullMove && depth >= NMP_DEPTH && staticEval >= beta
+            && beta < MATE_BOUND && HasNonPawnMaterial(b, b->side)
+            && (b->hisPly == 0 || b->history[b->hisPly - 1].move != NOMOVE)) {
+            int r = 3 + depth / 6;
+            if (staticEval - beta >= 200) r++;
+
+            MakeNullMove(b);
+            int score = -AlphaBeta(b, -beta, -beta + 1, depth - 1 - r, info);
+            UnmakeNullMove(b);
+
+            if (info->stopped) {
+                return 0;
+            }
             if (score >= beta) {
-                return beta; // Beta cutoff
+                return beta;
+            }
+        }
+    }
+
+    /* Futility: near the leaves, quiet moves that don't give check can't
+       lift a score this far below alpha */
+    bool futile = info->futility && !pvNode && !inCheck && depth <= FUTILITY_DEPTH
+               && alpha > -MATE_BOUND && staticEval + FutilityMargin[depth] <= alpha;
+
+    MovePicker mp;
+    InitMovePicker(&mp, b, ttMove, info->killers[ply], (const int (*)[BOARD_SIZE])info->history);
+#ifdef SEARCH_STATS
+    mp.stats = &info->stats;
+#endif
+
+    int oldAlpha = alpha;
+    Move bestMove = NOMOVE;
+    Move quiets[MAX_POSITION_MOVES];
+    int quietCount = 0;
+    int legalMoves = 0;
+    Move move;
+
+    while ((move = NextMove(&mp)) != NOMOVE) {
+        bool quiet = !IsCapture(move) && !IsPromotion(move);
+        int histScore = info->history[b->pieces[FromSq(move)]][ToSq(move)];
+        int score;
+
+        MakeMove(b, move);
+        bool givesCheck = InCheck(b);
+
+        if (futile && legalMoves > 0 && quiet && !givesCheck) {
+            UnmakeMove(b);
+            continue;
+        }
+        PrefetchChild(b, info, depth - 1);
+
+        if (legalMoves++ == 0) {
+            score = -AlphaBeta(b, -beta, -alpha, depth - 1, info);
+        }
+        else {
+            /* Late move reductions: quiet moves ordered this late rarely
+               matter, so search them shallower first and re-search at full
+               depth only if they beat alpha */
+            int r = 0;
+            if (info->lmr && depth >= LMR_DEPTH && legalMoves > LMR_MOVES && quiet
+                && !inCheck && !givesCheck
+                && move != info->killers[ply][0] && move != info->killers[ply][1]) {
+                r = Reductions[depth < MAX_DEPTH ? depth : MAX_DEPTH - 1]
+                              [legalMoves < MAX_POSITION_MOVES ? legalMoves : MAX_POSITION_MOVES - 1];
+                if (pvNode) r--;
+                r -= histScore / (MAX_HISTORY / 2);
+                if (r > depth - 2) r = depth - 2;
+                if (r < 0) r = 0;
             }
-            if (score > alpha) {
-                alpha = score;
-                info->bestMove = move; // Update best move
+
+            score = -AlphaBeta(b, -alpha - 1, -alpha, depth - 1 - r, info);
+            if (r > 0 && score > alpha) {
+                score = -AlphaBeta(b, -alpha - 1, -alpha, depth - 1, info);
             }
-        return alpha;
-    */
-    /* Placeholder implementation */
-    return 0;
+            if (score > alpha && score < beta) {
+                score = -AlphaBeta(b, -beta, -alpha, depth - 1, info);
+            }
+        }
+        UnmakeMove(b);
+
+        if (info->stopped) {
+            return 0;
+        }
+
+        if (score > alpha) {
+            bestMove = move;
+            if (score >= beta) {
+                STAT_INC(&info->stats, failHighs);
+                if (legalMoves == 1) {
+                    STAT_INC(&info->stats, failHighFirst);
+                }
+                if (!IsCapture(move)) {
+                    UpdateQuietStats(info, b, move, quiets, quietCount, depth);
+                }
+                StoreHashEntry(info->tt, b->posKey, depth, ScoreToTT(beta, ply), TT_BETA, bestMove);
+                return beta; /* Beta cutoff */
+            }
+            alpha = score;
+
+            /* New principal variation: this move, then the child's line */
+            info->pv[ply][0] = bestMove;
+            memcpy(&info->pv[ply][1], info->pv[ply + 1], info->pvLength[ply + 1] * sizeof(Move));
+            info->pvLength[ply] = info->pvLength[ply + 1] + 1;
+        }
+
+        if (!IsCapture(move)) {
+            quiets[quietCount++] = move;
+        }
+    }
+
+    if (legalMoves == 0) {
+        /* Checkmate or stalemate */
+        return inCheck ? -MATE + ply : 0;
+    }
+
+    StoreHashEntry(info->tt, b->posKey, depth, ScoreToTT(alpha, ply),
+                   (alpha > oldAlpha) ? TT_EXACT : TT_ALPHA, bestMove);
+    return alpha;
 }
 
 /*
     Quiescence:
     - Extends the search to capture moves to avoid the horizon effect.
+    - Skips captures that lose material by SEE, and captures whose victim
+      plus DELTA_MARGIN still can't lift the stand-pat score to alpha.
+    - In check (reachable with check extensions off) it searches all
+      evasions without standing pat, so mates are scored as mates.
 */
 int Quiescence(Board* b, int alpha, int beta, SearchInfo* info)
 {
-    /* 
-        Pseudocode:
-        int stand_pat = EvaluatePosition(b);
-        if (stand_pat >= beta) return beta;
-        if (stand_pat > alpha) alpha = stand_pat;
-
-        GenerateCaptures(b, captureList);
-        for each capture in captureList:
-            MakeMove(b, capture);
-            score = -Quiescence(b, -beta, -alpha, info);
-            UnmakeMove(b, capture);
-
-            if (score >= beta) return beta;
-            if (score > alpha) alpha = score;
-        return alpha;
-    */
-    /* Placeholder implementation */
-    return 0;
+    int ply = b->ply;
+    info->pvLength[ply] = 0;
+
+    if ((info->nodes & (CHECK_NODES - 1)) == 0 || info->nodes == info->nodeLimit) {
+        CheckUp(info);
+    }
+    CountNode(info);
+    STAT_INC(&info->stats, qnodes);
+    if (info->stopped) {
+        return 0;
+    }
+
+    int standPat = EvaluateSide(b, info);
+    if (ply >= MAX_DEPTH - 1) {
+        return standPat;
+    }
+
+    /* In check there is no standing pat: every evasion is searched */
+    bool inCheck = InCheck(b);
+    if (!inCheck) {
+        if (standPat >= beta) {
+            return beta;
+        }
+        if (standPat > alpha) {
+            alpha = standPat;
+        }
+    }
+
+    MovePicker mp;
+    if (inCheck) {
+        InitMovePicker(&mp, b, NOMOVE, NULL, (const int (*)[BOARD_SIZE])info->history);
+    }
+    else {
+        InitQuiescencePicker(&mp, b);
+    }
+#ifdef SEARCH_STATS
+    mp.stats = &info->stats;
+#endif
+    int legalMoves = 0;
+    Move move;
+
+    while ((move = NextMove(&mp)) != NOMOVE) {
+        legalMoves++;
+
+        /* Evasions are never pruned */
+        if (!inCheck) {
+            /* Delta pruning: even winning this piece for free can't reach alpha */
+            if (!IsPromotion(move)) {
+                int victim = IsEnPassant(move) ? PAWN : PieceType(b->pieces[ToSq(move)]);
+                if (standPat + SeeValue[victim] + DELTA_MARGIN <= alpha) {
+                    continue;
+                }
+            }
+            /* Captures that lose material by SEE are not worth resolving */
+            if (IsLosingCapture(b, move)) {
+                continue;
+            }
+        }
+
+        MakeMove(b, move);
+        PrefetchChild(b, info, 0);
+        int score = -Quiescence(b, -beta, -alpha, info);
+        UnmakeMove(b);
+
+        if (info->stopped) {
+            return 0;
+        }
+
+        if (score >= beta) {
+            return beta;
+        }
+        if (score > alpha) {
+            alpha = score;
+            info->pv[ply][0] = move;
+            memcpy(&info->pv[ply][1], info->pv[ply + 1], info->pvLength[ply + 1] * sizeof(Move));
+            info->pvLength[ply] = info->pvLength[ply + 1] + 1;
+        }
+    }
+
+    if (inCheck && legalMoves == 0) {
+        return -MATE + ply; /* Checkmate */
+    }
+    return alpha;
 }
@@ -5,33 +5,95 @@
     Description:
     - Header for the search routines (alpha-beta, quiescence, etc.).
     - Declares the SearchInfo struct to track search parameters and results.
+    - SearchPosition runs a Lazy SMP search: every thread searches its own
+      Board copy with its own SearchInfo, and all share one TransTable.
+    - StartSearch runs SearchPosition on a background thread so the UCI
+      loop keeps reading commands; StopSearch asks it to finish early.
 */
 
 #ifndef SEARCH_H
 #define SEARCH_H
 
+#include <stdint.h>
 #include "board.h"
 #include "movegen.h"
 #include "evaluate.h"
 #include "transposition.h"
+#include "stats.h"
 
-/* Structure to hold search parameters and results */
+#define MAX_DEPTH   64  /* Maximum search depth / ply from the root */
+#define MAX_THREADS 256 /* Upper limit for the Threads option */
+#define MAX_MULTIPV 64  /* Upper limit for the MultiPV option */
+
+struct ThreadGroup; /* The threads of one running search (search.c) */
+
+/* One legal root move with its result from the latest search of it */
+typedef struct {
+    Move move;
+    int score;          /* -INFINITY unless it raised alpha in the latest root search */
+    int prevScore;      /* score at the end of the previous iteration */
+    int pvLength;
+    Move pv[MAX_DEPTH + 1];
+} RootMove;
+
+/* Structure to hold search parameters and results (one per thread) */
 typedef struct {
     int depth;          /* Maximum search depth */
     int movetime;       /* Time allocated for the move in milliseconds */
-    int startTime;      /* Search start time (e.g., ms) */
-    int stopTime;       /* When we must stop searching */
-    long nodes;         /* Number of nodes visited in this search */
+    int timeLeft;       /* Clock of the side to move in ms (0 = no clock) */
+    int increment;      /* Increment per move in ms */
+    int movesToGo;      /* Moves to the next time control (0 = sudden death) */
+    int64_t startTime;  /* Search start time (GetTimeMs) */
+    int64_t clockStart; /* When our clock started: startTime, or the ponderhit */
+    int64_t softStopTime; /* Don't start another iteration after this */
+    int64_t stopTime;   /* When we must stop searching */
+    int stableIterations; /* Iterations in a row with the same best move */
+    uint64_t nodes;     /* Nodes visited (all threads once the search returns) */
+    uint64_t nodeLimit; /* Stop once the main thread has visited this many (0 = none) */
     bool timeSet;       /* True if a time limit is set */
+    bool infinite;      /* "go infinite": hold bestmove until "stop" */
+    bool ponder;        /* "go ponder": no time limit (and no bestmove) until "ponderhit" */
     bool stopped;       /* Set to true if we must stop immediately */
+    int multiPV;        /* Lines to search and report (1 = best move only) */
+    int pvIdx;          /* Line being searched; rootMoves before it are settled */
+    int searchMoveCount; /* "go searchmoves": only these root moves (0 = all) */
+    Move searchMoves[MAX_POSITION_MOVES];
+    int rootMoveCount;  /* Root move list, built once per SearchPosition and */
+    RootMove rootMoves[MAX_POSITION_MOVES]; /* kept sorted by score */
     Move bestMove;      /* Store the best move found */
-    /* Additional fields can be added as needed */
+    Move ponderMove;    /* Expected reply to bestMove (NOMOVE if unknown) */
+    int bestScore;      /* Score of bestMove, from the side to move's view */
+    int completedDepth; /* Last iteration that finished */
+    int threads;        /* Number of search threads, main thread included */
+    int threadId;       /* 0 for the main thread, 1.. for helpers */
+    TransTable* tt;     /* Shared transposition table */
+    struct ThreadGroup* group; /* Set by SearchPosition while it runs */
+    bool report;        /* Print "info" lines for each iteration */
+    bool nullMove;      /* Selective search switches (UCI options) */
+    bool lmr;
+    bool futility;      /* Futility and reverse futility pruning */
+    bool checkExtensions;
+    int tbPieces;       /* Probe tablebases with at most this many pieces (0 = off) */
+    uint64_t tbHits;    /* Successful tablebase probes */
+    Move killers[MAX_DEPTH + 1][2];         /* Quiet moves that caused cutoffs, per ply */
+    int history[13][BOARD_SIZE];            /* Quiet move scores by [piece][to] */
+    int pvLength[MAX_DEPTH + 1];            /* Triangular principal variation */
+    Move pv[MAX_DEPTH + 1][MAX_DEPTH + 1];
+    SearchStats stats;                      /* Only counted with SEARCH_STATS */
 } SearchInfo;
 
 /* Function prototypes */
+void InitSearch(void);   /* Once at startup, before any search */
 void ClearSearchInfo(SearchInfo* info);
 int  SearchPosition(Board* b, SearchInfo* info);
 int  AlphaBeta(Board* b, int alpha, int beta, int depth, SearchInfo* info);
 int  Quiescence(Board* b, int alpha, int beta, SearchInfo* info);
 
+/* Background search: starts SearchPosition on copies of b and limits,
+   prints "bestmove" when done. A running search is stopped first. */
+void StartSearch(const Board* b, const SearchInfo* limits);
+void StopSearch(void);    /* Asks a running search to stop (returns at once) */
+void PonderHit(void);     /* "ponderhit": the running ponder search goes on the clock */
+void WaitForSearch(void); /* Blocks until the background search has finished */
+
 #endif /* SEARCH_H */
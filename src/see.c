@@ -0,0 +1,119 @@
+/****************************************************************************
+ * File: see.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of Static Exchange Evaluation.
+    - Attackers of the target square come from AttackersTo on bitboards.
+      After each capture the capturing piece is removed from the occupancy
+      and the bishop/rook rays through the square are looked up again, so
+      x-ray attackers behind it (batteries) join the exchange.
+    - Pins are not considered, and a pawn recapturing on the last rank is
+      not treated as a promotion; both are rare enough for move ordering
+      and pruning purposes.
+*/
+
+#include "see.h"
+#include "movegen.h" /* For AttackersTo */
+
+const int SeeValue[7] = { 0, VAL_PAWN, VAL_KNIGHT, VAL_BISHOP, VAL_ROOK, VAL_QUEEN, VAL_KING };
+
+/*
+    SEE:
+    - gain[d] is the material balance after the d-th capture, seen by the
+      side that made it. Unwinding the list with negamax lets either side
+      stand pat instead of recapturing.
+    - Quiet moves work too: the result is then 0 or the loss of the mover.
+*/
+int SEE(const Board* b, Move move)
+{
+    int from = FromSq(move);
+    int to   = ToSq(move);
+    int gain[32];
+    int d = 0;
+
+    Bitboard occ = b->colorBB[BOTH] ^ SQ_BB(from);
+    int captured = b->pieces[to];
+    gain[0] = (captured != EMPTY) ? SeeValue[PieceType(captured)] : 0;
+
+    if (IsEnPassant(move)) {
+        int capSq = (b->side == WHITE) ? to - 8 : to + 8;
+        occ ^= SQ_BB(capSq);
+        gain[0] = SeeValue[PAWN];
+    }
+
+    /* Value of the piece that now stands on the target square */
+    int onSquare = SeeValue[PieceType(b->pieces[from])];
+    if (IsPromotion(move)) {
+        gain[0]  += SeeValue[PromotedType(move)] - SeeValue[PAWN];
+        onSquare  = SeeValue[PromotedType(move)];
+    }
+
+    Bitboard bishops = b->pieceBB[W_BISHOP] | b->pieceBB[B_BISHOP]
+                     | b->pieceBB[W_QUEEN]  | b->pieceBB[B_QUEEN];
+    Bitboard rooks   = b->pieceBB[W_ROOK]   | b->pieceBB[B_ROOK]
+                     | b->pieceBB[W_QUEEN]  | b->pieceBB[B_QUEEN];
+    Bitboard attackers = AttackersTo(b, to, occ) & occ;
+    int stm = b->side ^ 1;
+
+    while (d < 31) {
+        Bitboard ours = attackers & b->colorBB[stm];
+        if (!ours) break;
+
+        /* Least valuable attacker */
+        int type;
+        Bitboard bb = 0ULL;
+        for (type = PAWN; type <= KING; type++) {
+            bb = ours & b->pieceBB[MakePiece(type, stm)];
+            if (bb) break;
+        }
+
+        /* The king may only capture if nothing takes it back */
+        if (type == KING && (attackers & b->colorBB[stm ^ 1] & ~bb)) break;
+
+        d++;
+        gain[d] = onSquare - gain[d - 1];
+        onSquare = SeeValue[type];
+
+        /* Even an unanswered recapture would lose: the exchange ends here */
+        int next = onSquare - gain[d];
+        if ((-gain[d] > next ? -gain[d] : next) < 0) break;
+
+        occ ^= SQ_BB(Lsb(bb));
+        if (type == PAWN || type == BISHOP || type == QUEEN) {
+            attackers |= BishopAttacks(to, occ) & bishops;
+        }
+        if (type == ROOK || type == QUEEN) {
+            attackers |= RookAttacks(to, occ) & rooks;
+        }
+        attackers &= occ;
+        stm ^= 1;
+    }
+
+    while (d > 0) {
+        int standPat = -gain[d - 1];
+        if (gain[d] > standPat) standPat = gain[d];
+        gain[d - 1] = -standPat;
+        d--;
+    }
+    return gain[0];
+}
+
+/*
+    IsLosingCapture:
+    - Taking a piece at least as valuable as the attacker can never lose
+      material, so most captures are decided without running SEE.
+*/
+bool IsLosingCapture(const Board* b, Move move)
+{
+    int victim   = IsEnPassant(move) ? PAWN : PieceType(b->pieces[ToSq(move)]);
+    int attacker = PieceType(b->pieces[FromSq(move)]);
+
+    if (b->pieces[ToSq(move)] == EMPTY && !IsEnPassant(move)) {
+        victim = 0; /* Quiet move */
+    }
+    if (SeeValue[victim] >= SeeValue[attacker]) {
+        return false;
+    }
+    return SEE(b, move) < 0;
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+ * File: see.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for Static Exchange Evaluation (SEE).
+    - SEE plays out the whole capture sequence on a move's target square,
+      each side always recapturing with its least valuable piece and free
+      to stop when continuing would lose material. The result is the
+      material the moving side ends up winning (negative = losing).
+*/
+
+#ifndef SEE_H
+#define SEE_H
+
+#include "board.h"
+
+/* Material value of a colorless piece type, as used by SEE */
+extern const int SeeValue[7];
+
+/* Expected material gain of move for the side to move, in centipawns */
+int SEE(const Board* b, Move move);
+
+/* True if SEE(move) < 0; skips the exchange when the victim is worth at
+   least as much as the capturing piece */
+bool IsLosingCapture(const Board* b, Move move);
+
+#endif /* SEE_H */
@@ -0,0 +1,55 @@
+/****************************************************************************
+ * File: stats.c
+ ****************************************************************************/
+/*
+    Description:
+    - Summing and printing of the optional search statistics.
+*/
+
+#include "stats.h"
+#include <stdio.h>
+
+/* Share of part in whole, in percent */
+static double Percent(uint64_t part, uint64_t whole)
+{
+    return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+void AddSearchStats(SearchStats* into, const SearchStats* from)
+{
+    into->qnodes        += from->qnodes;
+    into->evalCalls     += from->evalCalls;
+    into->ttProbes      += from->ttProbes;
+    into->ttHits        += from->ttHits;
+    into->ttCutoffs     += from->ttCutoffs;
+    into->failHighs     += from->failHighs;
+    into->failHighFirst += from->failHighFirst;
+    into->pickTT        += from->pickTT;
+    into->genCaptures   += from->genCaptures;
+    into->pickKillers   += from->pickKillers;
+    into->genQuiets     += from->genQuiets;
+    into->genQsCaptures += from->genQsCaptures;
+}
+
+/*
+    PrintSearchStats:
+    - One line each for nodes, the TT, cutoffs and the move picker stages.
+*/
+void PrintSearchStats(const SearchStats* s, uint64_t nodes)
+{
+    printf("info string stats nodes %llu qnodes %llu (%.1f%%) evals %llu\n",
+           (unsigned long long)nodes, (unsigned long long)s->qnodes,
+           Percent(s->qnodes, nodes), (unsigned long long)s->evalCalls);
+    printf("info string stats tt probes %llu hits %llu (%.1f%%) cutoffs %llu (%.1f%%)\n",
+           (unsigned long long)s->ttProbes, (unsigned long long)s->ttHits,
+           Percent(s->ttHits, s->ttProbes), (unsigned long long)s->ttCutoffs,
+           Percent(s->ttCutoffs, s->ttProbes));
+    printf("info string stats failhigh %llu first %llu (%.1f%%)\n",
+           (unsigned long long)s->failHighs, (unsigned long long)s->failHighFirst,
+           Percent(s->failHighFirst, s->failHighs));
+    printf("info string stats picker tt %llu captures %llu killers %llu quiets %llu qcaptures %llu\n",
+           (unsigned long long)s->pickTT, (unsigned long long)s->genCaptures,
+           (unsigned long long)s->pickKillers, (unsigned long long)s->genQuiets,
+           (unsigned long long)s->genQsCaptures);
+    fflush(stdout);
+}
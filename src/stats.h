@@ -0,0 +1,46 @@
+/****************************************************************************
+ * File: stats.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the optional search statistics.
+    - The counters are only updated when the engine is built with
+      make STATS=1 (which defines SEARCH_STATS); otherwise every STAT_INC
+      compiles to nothing and the search pays no cost.
+    - Each thread counts into its own SearchInfo; the main thread sums them
+      and prints them as "info string" lines when the search ends.
+*/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t qnodes;        /* Quiescence nodes (part of SearchInfo.nodes) */
+    uint64_t evalCalls;     /* Static evaluations */
+    uint64_t ttProbes;      /* Full-width TT probes */
+    uint64_t ttHits;        /* Probes that found a deep enough entry */
+    uint64_t ttCutoffs;     /* Nodes cut off by the TT score */
+    uint64_t failHighs;     /* Full-width beta cutoffs */
+    uint64_t failHighFirst; /* ... of which by the first move searched */
+    uint64_t pickTT;        /* Move picker: TT moves handed out */
+    uint64_t genCaptures;   /* Move picker: capture generations (full-width) */
+    uint64_t pickKillers;   /* Move picker: killers handed out */
+    uint64_t genQuiets;     /* Move picker: quiet generations */
+    uint64_t genQsCaptures; /* Move picker: capture generations (quiescence) */
+} SearchStats;
+
+#ifdef SEARCH_STATS
+#define STAT_INC(stats, field) ((stats)->field++)
+#else
+#define STAT_INC(stats, field) ((void)0)
+#endif
+
+/* Adds every counter of from to into */
+void AddSearchStats(SearchStats* into, const SearchStats* from);
+
+/* Prints the counters as UCI "info string" lines; nodes = total nodes */
+void PrintSearchStats(const SearchStats* stats, uint64_t nodes);
+
+#endif /* STATS_H */
@@ -0,0 +1,163 @@
+/****************************************************************************
+ * File: syzygy.c
+ ****************************************************************************/
+/*
+    Description:
+    - Syzygy tablebase probing through Fathom's tbprobe.h API.
+    - Fathom keeps a table-file registry built by tb_init() (existence
+      checks only) and maps each file with mmap(PROT_READ, MAP_SHARED),
+      or a file mapping on Windows, on the first probe that needs it.
+      Mapped pages come from the OS page cache, so processes on the same
+      host (or reading the same NFS mount) share them and pages that are
+      never probed are never read.
+    - Fathom's squares (a1 = 0 ... h8 = 63) and colors match ours, so a
+      Board converts to its bitboard arguments directly.
+    - Built without USE_FATHOM, TbInit only reports that support is
+      missing and every probe fails, which the search treats as "not in
+      the tables".
+*/
+
+#include "syzygy.h"
+#include "log.h"
+#include "movegen.h"
+#include <string.h>
+
+#ifdef USE_FATHOM
+#include "tbprobe.h"
+
+/* Fathom's argument list for a position */
+#define TB_ARGS(b) \
+    (b)->colorBB[WHITE], (b)->colorBB[BLACK], \
+    (b)->pieceBB[W_KING]   | (b)->pieceBB[B_KING], \
+    (b)->pieceBB[W_QUEEN]  | (b)->pieceBB[B_QUEEN], \
+    (b)->pieceBB[W_ROOK]   | (b)->pieceBB[B_ROOK], \
+    (b)->pieceBB[W_BISHOP] | (b)->pieceBB[B_BISHOP], \
+    (b)->pieceBB[W_KNIGHT] | (b)->pieceBB[B_KNIGHT], \
+    (b)->pieceBB[W_PAWN]   | (b)->pieceBB[B_PAWN]
+
+/* Fathom's WDL values (TB_LOSS = 0 ... TB_WIN = 4) to ours */
+static int FromFathomWdl(unsigned wdl)
+{
+    return (int)wdl - 2;
+}
+#endif
+
+/*
+    TbInit:
+    - (Re)initialises the tablebases. Fathom unmaps any previously mapped
+      files first, so it must not run during a search.
+*/
+bool TbInit(const char* path)
+{
+    bool disabled = !path || !path[0] || strcmp(path, "<empty>") == 0;
+
+#ifdef USE_FATHOM
+    if (!tb_init(disabled ? "" : path)) {
+        LogError("Syzygy: initialisation failed for %s\n", path);
+        return false;
+    }
+    if (disabled) {
+        return true;
+    }
+    if (TB_LARGEST == 0) {
+        LogWarn("Syzygy: no tablebase files found in %s\n", path);
+        return false;
+    }
+    LogInfo("Syzygy: found tables up to %u pieces\n", TB_LARGEST);
+    return true;
+#else
+    if (disabled) {
+        return true;
+    }
+    LogWarn("Syzygy: support not compiled in (build with make FATHOM=<dir>)\n");
+    return false;
+#endif
+}
+
+int TbLargest(void)
+{
+#ifdef USE_FATHOM
+    return (int)TB_LARGEST;
+#else
+    return 0;
+#endif
+}
+
+/*
+    TbProbeWdl:
+    - Castling rights and a running fifty-move clock make the stored WDL
+      inexact, so those positions aren't probed (Fathom refuses them too).
+*/
+bool TbProbeWdl(const Board* b, int* wdl)
+{
+#ifdef USE_FATHOM
+    if (b->castlePerm || b->fiftyMove
+        || PopCount(b->colorBB[BOTH]) > (int)TB_LARGEST) {
+        return false;
+    }
+
+    unsigned result = tb_probe_wdl(TB_ARGS(b), 0, 0,
+                                   b->enPas == NO_SQ ? 0 : (unsigned)b->enPas,
+                                   b->side == WHITE);
+    if (result == TB_RESULT_FAILED) {
+        return false;
+    }
+    *wdl = FromFathomWdl(result);
+    return true;
+#else
+    (void)b;
+    (void)wdl;
+    return false;
+#endif
+}
+
+/*
+    TbProbeRoot:
+    - Asks Fathom for the result of every legal root move and matches
+      each of ours against it. Fathom's root probe isn't thread-safe;
+      only the search thread calls it, before any helper starts.
+*/
+bool TbProbeRoot(const Board* b, const Move* moves, int count, int* wdl, int* dtz)
+{
+#ifdef USE_FATHOM
+    if (b->castlePerm || PopCount(b->colorBB[BOTH]) > (int)TB_LARGEST) {
+        return false;
+    }
+
+    unsigned results[TB_MAX_MOVES];
+    unsigned result = tb_probe_root(TB_ARGS(b), (unsigned)b->fiftyMove, 0,
+                                    b->enPas == NO_SQ ? 0 : (unsigned)b->enPas,
+                                    b->side == WHITE, results);
+    if (result == TB_RESULT_FAILED || result == TB_RESULT_CHECKMATE
+        || result == TB_RESULT_STALEMATE) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        Move m = moves[i];
+        int j;
+        for (j = 0; results[j] != TB_RESULT_FAILED; j++) {
+            int from  = (int)TB_GET_FROM(results[j]);
+            int to    = (int)TB_GET_TO(results[j]);
+            int promo = (int)TB_GET_PROMOTES(results[j]); /* TB_PROMOTES_QUEEN = 1 ... KNIGHT = 4 */
+
+            if (FromSq(m) != from || ToSq(m) != to) continue;
+            if (IsPromotion(m) ? PromotedType(m) != QUEEN + 1 - promo : promo != 0) continue;
+            break;
+        }
+        if (results[j] == TB_RESULT_FAILED) {
+            return false;
+        }
+        wdl[i] = FromFathomWdl(TB_GET_WDL(results[j]));
+        dtz[i] = (int)TB_GET_DTZ(results[j]);
+    }
+    return true;
+#else
+    (void)b;
+    (void)moves;
+    (void)count;
+    (void)wdl;
+    (void)dtz;
+    return false;
+#endif
+}
@@ -0,0 +1,54 @@
+/****************************************************************************
+ * File: syzygy.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for Syzygy endgame tablebase probing.
+    - The probing itself is done by Fathom (built in with make FATHOM=<dir>,
+      see the Makefile). Fathom only checks which files exist when the path
+      is set; each table is memory-mapped read-only the first time a probe
+      needs it, so an unused 6/7-man set costs no RAM and the OS page cache
+      is shared by every engine process reading the same files.
+    - Without Fathom the functions below report no tablebases and the
+      search runs as before.
+*/
+
+#ifndef SYZYGY_H
+#define SYZYGY_H
+
+#include <stdbool.h>
+#include "board.h"
+
+/* WDL results, from the side to move's point of view */
+#define WDL_LOSS          -2
+#define WDL_BLESSED_LOSS  -1 /* Lost, but drawn under the fifty-move rule */
+#define WDL_DRAW           0
+#define WDL_CURSED_WIN     1 /* Won, but drawn under the fifty-move rule */
+#define WDL_WIN            2
+
+/*
+   Set the tablebase directories (separated by ':', or ';' on Windows).
+   An empty path or "<empty>" disables probing. Returns false if the path
+   is set but no tables were found or support isn't compiled in.
+*/
+bool TbInit(const char* path);
+
+/* Most pieces (kings included) of any table found, 0 without tablebases */
+int TbLargest(void);
+
+/*
+   WDL probe for a search node. Only succeeds for positions with at most
+   TbLargest() pieces, no castling rights and a fresh fifty-move clock
+   (right after a capture or pawn move), which is where WDL is exact.
+*/
+bool TbProbeWdl(const Board* b, int* wdl);
+
+/*
+   DTZ probe at the root: fills wdl[i] with the result of playing moves[i]
+   (from the side to move's point of view, fifty-move rule included) and
+   dtz[i] with the plies to the next capture or pawn move after it. Fails
+   for positions not in the tables or moves Fathom doesn't list.
+*/
+bool TbProbeRoot(const Board* b, const Move* moves, int count, int* wdl, int* dtz);
+
+#endif /* SYZYGY_H */
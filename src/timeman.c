@@ -0,0 +1,88 @@
+/****************************************************************************
+ * File: timeman.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of the time manager.
+    - With a clock, the budget for this move is the remaining time split over
+      the moves still to play (MOVES_HORIZON if the GUI doesn't say), plus
+      most of the increment. The hard limit allows overrunning that budget
+      a few times, but never more than a fixed share of the clock.
+    - "movetime" uses the given time as both limits.
+*/
+
+#include "timeman.h"
+#include "misc.h"
+
+#define MOVE_OVERHEAD  30 /* ms kept back for GUI / communication lag */
+#define MOVES_HORIZON  30 /* Assumed moves left in sudden death */
+#define MAX_STRETCH     5 /* Hard limit is at most this many soft budgets */
+
+/*
+    InitTimeManager:
+    - Must run after info->clockStart is set. On a ponderhit it runs again,
+      so the budget counts from the moment our clock started.
+    - Leaves timeSet false when there's no clock and no movetime, so the
+      search only stops on depth or "stop".
+*/
+void InitTimeManager(SearchInfo* info)
+{
+    info->stableIterations = 0;
+
+    if (info->movetime > 0) {
+        info->timeSet      = true;
+        info->softStopTime = info->clockStart + info->movetime;
+        info->stopTime     = info->clockStart + info->movetime;
+        return;
+    }
+
+    if (info->timeLeft <= 0) {
+        info->timeSet = false;
+        return;
+    }
+
+    int movesToGo = (info->movesToGo > 0) ? info->movesToGo : MOVES_HORIZON;
+    if (movesToGo > 50) movesToGo = 50;
+
+    int64_t available = info->timeLeft - MOVE_OVERHEAD;
+    if (available < 1) available = 1;
+
+    int64_t soft = available / movesToGo + info->increment * 3 / 4;
+    int64_t hard = soft * MAX_STRETCH;
+
+    /* Never plan to use more than 3/4 of the clock on one move, and on
+       the last move before the time control stay inside what's left */
+    int64_t cap = (movesToGo == 1) ? available * 9 / 10 : available * 3 / 4;
+    if (hard > cap)  hard = cap;
+    if (soft > hard) soft = hard;
+    if (soft < 1)    soft = 1;
+
+    info->timeSet      = true;
+    info->softStopTime = info->clockStart + soft;
+    info->stopTime     = info->clockStart + hard;
+}
+
+/*
+    StopAfterIteration:
+    - A new best move stretches the soft budget by half, while three or
+      more stable iterations shrink it to 60%; time spent beyond that is
+      most likely wasted on an iteration that won't change the move.
+*/
+bool StopAfterIteration(SearchInfo* info, bool bestMoveChanged)
+{
+    info->stableIterations = bestMoveChanged ? 0 : info->stableIterations + 1;
+
+    if (!info->timeSet || info->movetime > 0) {
+        return false;
+    }
+
+    int64_t budget = info->softStopTime - info->clockStart;
+    if (bestMoveChanged) {
+        budget = budget * 3 / 2;
+    }
+    else if (info->stableIterations >= 3) {
+        budget = budget * 6 / 10;
+    }
+
+    return GetTimeMs() - info->clockStart >= budget;
+}
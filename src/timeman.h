@@ -0,0 +1,31 @@
+/****************************************************************************
+ * File: timeman.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for the time manager.
+    - Turns the UCI clock ("wtime/btime/winc/binc/movestogo" or "movetime")
+      into two deadlines per move:
+        soft: don't start another iteration after this point
+        hard: abort the running iteration (checked inside the search)
+    - The soft deadline is stretched when the best move keeps changing and
+      shortened when it has been stable for several iterations.
+*/
+
+#ifndef TIMEMAN_H
+#define TIMEMAN_H
+
+#include <stdbool.h>
+#include "search.h"
+
+/* Sets timeSet, softStopTime and stopTime from the limits in info */
+void InitTimeManager(SearchInfo* info);
+
+/*
+   Called by the main thread after each completed iteration.
+   bestMoveChanged tells whether this iteration picked a new best move.
+   Returns true if the search should not start the next iteration.
+*/
+bool StopAfterIteration(SearchInfo* info, bool bestMoveChanged);
+
+#endif /* TIMEMAN_H */
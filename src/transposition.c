@@ -8,31 +8,242 @@
    - Stores depth, score, and best move data to speed up future searches.
 
    Implementation details:
-   1) Memory allocation for TT entries.
-   2) Simple replacement scheme for collisions (replace if depth >= current entry).
-   3) Retrieving (probing) an entry if the key matches and depth is sufficient.
+   1) The table is an array of 64-byte buckets, so a probe touches exactly
+      one cache line. Each bucket holds TT_BUCKET_SIZE 8-byte entries.
+   2) The bucket index is the high half of key * numBuckets (multiply-shift,
+      see TTBucketFor), which avoids a division and works for any bucket
+      count. The low 16 bits of the key are stored in the entry to verify
+      the match.
+   3) Replacement: a slot with the same key is reused; otherwise the entry
+      with the lowest depth minus an age penalty is overwritten, so results
+      of old searches are dropped first.
+   4) Entries are loaded and stored as single atomic 64-bit words, so the
+      search threads can share the table without locks.
+   5) The buckets are allocated on large pages where available and cleared
+      by several threads at once.
+   6) Snapshots (savehash / loadhash) are a 64-byte TTFileHeader followed
+      by the buckets exactly as they are in memory, so a load maps the file
+      and copies the buckets in with a few bulk copies, like clearing.
+      The header fixes everything the raw entries depend on: the entry
+      layout (version, byte order, bucket size), the Zobrist keys and the
+      bucket count, which the bucket index is derived from.
 */
 
 #include "transposition.h"
+#include "misc.h"
+#include "zobrist.h"
+#include <pthread.h>
 #include <stdio.h>   /* For fprintf, stderr */
-#include <stdlib.h>  /* For calloc, free */
+#include <stdlib.h>  /* For posix_memalign, free */
+#include <string.h>  /* For memset */
+#ifdef _WIN32
+#include <windows.h> /* For VirtualAlloc */
+#include <malloc.h>  /* For _aligned_malloc */
+#else
+#include <fcntl.h>    /* For open */
+#include <sys/mman.h> /* For mmap, madvise */
+#include <sys/stat.h> /* For fstat */
+#include <unistd.h>   /* For close */
+#endif
+
+#define TT_DEPTH_OFFSET 1   /* depth8 = depth + 1, so 0 marks an empty slot */
+#define TT_GEN_MASK     63  /* Generation is stored in the upper 6 bits */
+#define TT_AGE_WEIGHT   8   /* Depth plies one generation of age is worth */
+
+#define HUGE_PAGE_SIZE    (2u << 20)  /* x86-64 / ARM64 large page */
+#define TT_CLEAR_SLICE    (32u << 20) /* Bytes worth giving a clearing thread */
+#define TT_CLEAR_THREADS  64
+
+#define TT_FILE_MAGIC      "BEARHASH"
+#define TT_FILE_VERSION    1          /* Bump whenever TTEntry or TTBucket change */
+#define TT_FILE_BYTE_ORDER 0x01020304 /* Reads back differently on the other endianness */
+#define TT_SAVE_CHUNK      4096       /* Buckets copied out per write */
+
+/* Snapshot file header; the buckets follow it */
+typedef struct {
+    char     magic[8];     /* TT_FILE_MAGIC, no terminator */
+    uint32_t version;      /* TT_FILE_VERSION */
+    uint32_t byteOrder;    /* TT_FILE_BYTE_ORDER */
+    uint32_t bucketBytes;  /* sizeof(TTBucket) */
+    uint32_t age;          /* Search generation at the time of the save */
+    uint64_t numBuckets;
+    uint64_t zobristCheck; /* SideKey: entries are only valid with the same keys */
+    uint8_t  reserved[24];
+} TTFileHeader;
+
+_Static_assert(sizeof(TTEntry) == 8, "TTEntry must stay 8 bytes");
+_Static_assert(sizeof(TTBucket) == 64, "TTBucket must fill one cache line");
+_Static_assert(sizeof(TTFileHeader) == 64, "Buckets in a snapshot must stay cache-line aligned");
+
+/* Allocates size bytes on an alignment boundary (NULL on failure) */
+static void* AlignedAlloc(size_t size, size_t alignment)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* mem = NULL;
+    if (posix_memalign(&mem, alignment, size) != 0) {
+        return NULL;
+    }
+    return mem;
+#endif
+}
+
+static void AlignedFree(void* mem)
+{
+#ifdef _WIN32
+    _aligned_free(mem);
+#else
+    free(mem);
+#endif
+}
+
+#ifdef _WIN32
+/*
+   Large pages need the "Lock pages in memory" privilege, which must be
+   granted to the user and then enabled for the process. Returns NULL when
+   either step fails; *size is rounded up to the large page size.
+*/
+static void* AllocLargePages(size_t* size)
+{
+    SIZE_T pageSize = GetLargePageMinimum();
+    HANDLE token;
+    TOKEN_PRIVILEGES tp;
+    void* mem = NULL;
+
+    if (!pageSize || !OpenProcessToken(GetCurrentProcess(),
+                                       TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return NULL;
+    }
+    if (LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid)) {
+        tp.PrivilegeCount = 1;
+        tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        if (AdjustTokenPrivileges(token, FALSE, &tp, 0, NULL, NULL)
+            && GetLastError() == ERROR_SUCCESS) {
+            size_t rounded = (*size + pageSize - 1) / pageSize * pageSize;
+            mem = VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                               PAGE_READWRITE);
+            if (mem) *size = rounded;
+        }
+    }
+    CloseHandle(token);
+    return mem;
+}
+#endif
+
+/*
+   AllocTable:
+   - Gets the bucket memory, preferring large pages so that random probes
+     don't miss the TLB on nearly every access:
+       Linux:   explicit huge pages (MAP_HUGETLB) if the system has any
+                reserved, else 2MB-aligned memory marked MADV_HUGEPAGE for
+                transparent huge pages
+       Windows: VirtualAlloc with MEM_LARGE_PAGES
+     falling back to ordinary cache-line-aligned memory.
+   - Records how the memory was obtained, for FreeTable.
+*/
+static bool AllocTable(TransTable* tt, size_t bytes)
+{
+    tt->allocKind = TT_ALLOC_HEAP;
+    tt->allocSize = bytes;
+
+#ifdef _WIN32
+    size_t large = bytes;
+    void* mem = AllocLargePages(&large);
+    if (mem) {
+        tt->buckets   = (TTBucket*)mem;
+        tt->allocKind = TT_ALLOC_LARGE;
+        tt->allocSize = large;
+        return true;
+    }
+#elif defined(__linux__)
+    if (bytes >= HUGE_PAGE_SIZE) {
+        size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#ifdef MAP_HUGETLB
+        void* mem = mmap(NULL, rounded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            tt->buckets   = (TTBucket*)mem;
+            tt->allocKind = TT_ALLOC_LARGE;
+            tt->allocSize = rounded;
+            return true;
+        }
+#endif
+        tt->buckets = (TTBucket*)AlignedAlloc(rounded, HUGE_PAGE_SIZE);
+        if (tt->buckets) {
+#ifdef MADV_HUGEPAGE
+            madvise(tt->buckets, rounded, MADV_HUGEPAGE);
+#endif
+            tt->allocSize = rounded;
+            return true;
+        }
+    }
+#endif
+
+    tt->buckets = (TTBucket*)AlignedAlloc(bytes, 64);
+    return tt->buckets != NULL;
+}
+
+static void FreeTable(TransTable* tt)
+{
+    if (tt->allocKind == TT_ALLOC_LARGE) {
+#ifdef _WIN32
+        VirtualFree(tt->buckets, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        munmap(tt->buckets, tt->allocSize);
+#endif
+    }
+    else {
+        AlignedFree(tt->buckets);
+    }
+}
+
+/* Atomic whole-entry load and store (relaxed: only tearing matters here) */
+static inline TTEntry LoadEntry(const TTBucket* bucket, int i)
+{
+    uint64_t raw = __atomic_load_n(&bucket->entries[i], __ATOMIC_RELAXED);
+    TTEntry e;
+    memcpy(&e, &raw, sizeof(e));
+    return e;
+}
+
+static inline void SaveEntry(TTBucket* bucket, int i, const TTEntry* e)
+{
+    uint64_t raw;
+    memcpy(&raw, e, sizeof(raw));
+    __atomic_store_n(&bucket->entries[i], raw, __ATOMIC_RELAXED);
+}
+
+static inline int EntryGeneration(const TTEntry* e) { return e->genBound >> 2; }
+static inline int EntryBound(const TTEntry* e)      { return e->genBound & 3; }
+
+/* Generations elapsed since the entry was written (0 = current search) */
+static inline int RelativeAge(const TransTable* tt, const TTEntry* e)
+{
+    return (tt->age - EntryGeneration(e)) & TT_GEN_MASK;
+}
 
 /*
    InitTranspositionTable:
-   - Allocates TTEntry array of given size.
-   - Resets counters (newWrite, age).
+   - Allocates enough 64-byte buckets for size entries (at least one bucket),
+     on large pages where the system allows it, and clears them.
+   - Resets the search generation (age).
 */
 void InitTranspositionTable(TransTable* tt, size_t size)
 {
-    tt->entries = (TTEntry*)calloc(size, sizeof(TTEntry));
-    if (!tt->entries) {
+    size_t numBuckets = size / TT_BUCKET_SIZE;
+    if (numBuckets == 0) numBuckets = 1;
+
+    if (!AllocTable(tt, numBuckets * sizeof(TTBucket))) {
         fprintf(stderr, "Error: Unable to allocate memory for Transposition Table\n");
+        tt->buckets    = NULL;
+        tt->numBuckets = 0;
         tt->numEntries = 0;
         return;
     }
-    tt->numEntries = size;
-    tt->newWrite   = 0;
-    tt->age        = 0;
+    tt->numBuckets = numBuckets;
+    tt->numEntries = numBuckets * TT_BUCKET_SIZE;
+    ClearTranspositionTable(tt);
 }
 
 /*
@@ -41,69 +252,413 @@ void InitTranspositionTable(TransTable* tt, size_t size)
 */
 void FreeTranspositionTable(TransTable* tt)
 {
-    if (tt->entries) {
-        free(tt->entries);
-        tt->entries = NULL;
+    if (tt->buckets) {
+        FreeTable(tt);
+        tt->buckets = NULL;
     }
+    tt->numBuckets = 0;
     tt->numEntries = 0;
-    tt->newWrite   = 0;
     tt->age        = 0;
 }
 
+/*
+   ResizeTranspositionTable:
+   - The old table is freed before the new one is allocated, so resizing
+     never needs both at once.
+*/
+bool ResizeTranspositionTable(TransTable* tt, size_t megabytes)
+{
+    size_t oldEntries = tt->numEntries;
+    size_t entries = megabytes * 1024 * 1024 / sizeof(TTBucket) * TT_BUCKET_SIZE;
+
+    FreeTranspositionTable(tt);
+    InitTranspositionTable(tt, entries);
+    if (tt->buckets) {
+        return true;
+    }
+
+    InitTranspositionTable(tt, oldEntries);
+    return false;
+}
+
+/* One thread's share of the table for FillTable */
+typedef struct {
+    TTBucket* start;
+    size_t count;
+    const TTBucket* source; /* Copied from, or NULL to zero the slice */
+} FillSlice;
+
+static void* FillWorker(void* arg)
+{
+    FillSlice* slice = (FillSlice*)arg;
+    if (slice->source) {
+        memcpy(slice->start, slice->source, slice->count * sizeof(TTBucket));
+    }
+    else {
+        memset(slice->start, 0, slice->count * sizeof(TTBucket));
+    }
+    return NULL;
+}
+
+/*
+   FillTable:
+   - Splits the table into one slice per CPU (for tables big enough to be
+     worth it) and zeroes the slices, or copies them from source, in
+     parallel; the calling thread does the first slice itself. A slice
+     whose thread can't be started is done by the caller too.
+   - Either way every page is faulted in, so the table is fully backed
+     before the first search uses it.
+*/
+static void FillTable(TransTable* tt, const TTBucket* source)
+{
+    size_t bytes = tt->numBuckets * sizeof(TTBucket);
+    size_t threads = (size_t)CpuCount();
+    if (threads > TT_CLEAR_THREADS)         threads = TT_CLEAR_THREADS;
+    if (threads > bytes / TT_CLEAR_SLICE)   threads = bytes / TT_CLEAR_SLICE;
+    if (threads < 1)                        threads = 1;
+
+    FillSlice  slices[TT_CLEAR_THREADS];
+    pthread_t  workers[TT_CLEAR_THREADS];
+    bool       started[TT_CLEAR_THREADS] = { false };
+    size_t per = tt->numBuckets / threads;
+
+    for (size_t i = 0; i < threads; i++) {
+        slices[i].start  = tt->buckets + i * per;
+        slices[i].count  = (i == threads - 1) ? tt->numBuckets - i * per : per;
+        slices[i].source = source ? source + i * per : NULL;
+    }
+    for (size_t i = 1; i < threads; i++) {
+        started[i] = pthread_create(&workers[i], NULL, FillWorker, &slices[i]) == 0;
+    }
+    FillWorker(&slices[0]);
+    for (size_t i = 1; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(workers[i], NULL);
+        }
+        else {
+            FillWorker(&slices[i]);
+        }
+    }
+}
+
+/*
+   ClearTranspositionTable:
+   - Zeroes every bucket in parallel (FillTable) and resets the age.
+*/
+void ClearTranspositionTable(TransTable* tt)
+{
+    if (!tt->buckets) return;
+
+    FillTable(tt, NULL);
+    tt->age = 0;
+}
+
 /*
    StoreHashEntry:
-   - Basic hash function using key % numEntries as index.
-   - If the slot is empty (key=0), or matches the same key, or new depth >= old depth,
-     we overwrite. Otherwise, do nothing (simple approach).
-   - In practice, you'd want a more robust collision scheme (e.g., 2-slot, buckets, etc.).
+   - Looks for a slot with the same key in the bucket; if none, picks the
+     slot with the lowest (depth - TT_AGE_WEIGHT * age), so empty slots and
+     shallow or stale entries go first.
+   - An entry of the same position is kept if it came from this search, is
+     much deeper and the new result is not exact.
+   - A missing bestMove does not erase the one already stored for the key.
 */
-void StoreHashEntry(TransTable* tt, uint64_t key, int depth, int score, 
+void StoreHashEntry(TransTable* tt, uint64_t key, int depth, int score,
                     int flag, Move bestMove)
 {
-    if (!tt->entries || tt->numEntries == 0) return;
+    if (!tt->buckets) return;
+
+    TTBucket* bucket = TTBucketFor(tt, key);
+    uint16_t key16 = (uint16_t)key;
+    int slot = 0;
+    int worst = INFINITY;
+    TTEntry old = LoadEntry(bucket, 0);
 
-    size_t index = key % tt->numEntries;
-    TTEntry* entry = &tt->entries[index];
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        TTEntry e = LoadEntry(bucket, i);
 
-    /* Check if entry is empty or same key or we have deeper depth => replace */
-    if (entry->key == 0ULL || entry->key == key || depth >= entry->depth) {
-        entry->key      = key;
-        entry->depth    = depth;
-        entry->score    = score;
-        entry->flag     = flag;
-        entry->bestMove = bestMove;
-        entry->age      = tt->age;
-        tt->newWrite++;
+        if (e.depth8 != 0 && e.key16 == key16) {
+            slot = i;
+            old  = e;
+            break;
+        }
+
+        int value = e.depth8 - TT_AGE_WEIGHT * RelativeAge(tt, &e);
+        if (value < worst) {
+            worst = value;
+            slot  = i;
+            old   = e;
+        }
     }
-    /* else: keep the old entry (simple collision policy) */
+
+    if (old.depth8 != 0 && old.key16 == key16) {
+        if (flag != TT_EXACT
+            && RelativeAge(tt, &old) == 0
+            && depth + TT_DEPTH_OFFSET + 3 < old.depth8) {
+            return;
+        }
+        if (bestMove == NOMOVE) {
+            bestMove = old.bestMove;
+        }
+    }
+
+    if (depth < 0) depth = 0;
+    if (depth > 254 - TT_DEPTH_OFFSET) depth = 254 - TT_DEPTH_OFFSET;
+
+    TTEntry e;
+    e.key16    = key16;
+    e.bestMove = bestMove;
+    e.score    = (int16_t)score;
+    e.depth8   = (uint8_t)(depth + TT_DEPTH_OFFSET);
+    e.genBound = (uint8_t)((tt->age << 2) | (flag & 3));
+    SaveEntry(bucket, slot, &e);
 }
 
 /*
    ProbeHashEntry:
-   - Check if there's an entry with the same key.
-   - If found and entry->depth >= requested depth, we consider it valid.
-   - Returns true if successful, false otherwise. outScore/outMove are set if found.
+   - Scans the bucket for an entry whose stored key bits match.
+   - On a match the best move is returned even if the entry is too shallow,
+     since it is still the best guess for move ordering.
+   - Returns true only if entry depth >= requested depth; outScore/outFlag
+     are set in that case.
 */
-bool ProbeHashEntry(TransTable* tt, uint64_t key, int depth, int* outScore, 
-                    Move* outMove)
+bool ProbeHashEntry(TransTable* tt, uint64_t key, int depth, int* outScore,
+                    int* outFlag, Move* outMove)
 {
-    if (!tt->entries || tt->numEntries == 0) {
+    if (!tt->buckets) {
         return false;
     }
 
-    size_t index = key % tt->numEntries;
-    TTEntry* entry = &tt->entries[index];
+    const TTBucket* bucket = TTBucketFor(tt, key);
+    uint16_t key16 = (uint16_t)key;
 
-    /* Check for a match and if the stored depth is >= required depth. */
-    if (entry->key == key && entry->depth >= depth) {
-        if (outScore) {
-            *outScore = entry->score;
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        TTEntry e = LoadEntry(bucket, i);
+        if (e.depth8 == 0 || e.key16 != key16) {
+            continue;
         }
+
         if (outMove) {
-            *outMove = entry->bestMove;
+            *outMove = e.bestMove;
+        }
+        if (e.depth8 - TT_DEPTH_OFFSET < depth) {
+            return false;
+        }
+        if (outScore) {
+            *outScore = e.score;
+        }
+        if (outFlag) {
+            *outFlag = EntryBound(&e);
         }
         return true;
     }
 
     return false;
 }
+
+/*
+   IncrementTTAge:
+   - Called once at the start of each search; entries written earlier now
+     count as older in the replacement scheme.
+*/
+void IncrementTTAge(TransTable* tt)
+{
+    tt->age = (tt->age + 1) & TT_GEN_MASK;
+}
+
+/*
+   HashFull:
+   - Samples the first 1000 slots (125 buckets) and counts the ones written
+     during the current search generation.
+*/
+int HashFull(const TransTable* tt)
+{
+    size_t buckets = 1000 / TT_BUCKET_SIZE;
+    if (buckets > tt->numBuckets) buckets = tt->numBuckets;
+    if (buckets == 0) return 0;
+
+    int used = 0;
+    for (size_t i = 0; i < buckets; i++) {
+        for (int j = 0; j < TT_BUCKET_SIZE; j++) {
+            TTEntry e = LoadEntry(&tt->buckets[i], j);
+            if (e.depth8 != 0 && RelativeAge(tt, &e) == 0) {
+                used++;
+            }
+        }
+    }
+    return (int)(used * 1000 / (buckets * TT_BUCKET_SIZE));
+}
+
+/*
+   SaveTranspositionTable:
+   - Copies the buckets out a chunk at a time with the same atomic word
+     loads the search uses, so a table in use is saved without torn
+     entries (though not as one consistent moment in time).
+*/
+bool SaveTranspositionTable(const TransTable* tt, const char* path)
+{
+    if (!tt->buckets || !path || !path[0]) return false;
+
+    char tmpPath[4096];
+    if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int)sizeof(tmpPath)) {
+        return false;
+    }
+    TTBucket* chunk = (TTBucket*)AlignedAlloc(TT_SAVE_CHUNK * sizeof(TTBucket), 64);
+    FILE* f = fopen(tmpPath, "wb");
+    if (!chunk || !f) {
+        fprintf(stderr, "Error: Unable to write %s\n", tmpPath);
+        AlignedFree(chunk);
+        if (f) fclose(f);
+        return false;
+    }
+
+    TTFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TT_FILE_MAGIC, sizeof(header.magic));
+    header.version      = TT_FILE_VERSION;
+    header.byteOrder    = TT_FILE_BYTE_ORDER;
+    header.bucketBytes  = sizeof(TTBucket);
+    header.age          = (uint32_t)tt->age;
+    header.numBuckets   = tt->numBuckets;
+    header.zobristCheck = SideKey;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    for (size_t done = 0; ok && done < tt->numBuckets; ) {
+        size_t count = tt->numBuckets - done;
+        if (count > TT_SAVE_CHUNK) count = TT_SAVE_CHUNK;
+        for (size_t i = 0; i < count; i++) {
+            for (int j = 0; j < TT_BUCKET_SIZE; j++) {
+                chunk[i].entries[j] = __atomic_load_n(&tt->buckets[done + i].entries[j],
+                                                      __ATOMIC_RELAXED);
+            }
+        }
+        ok = fwrite(chunk, sizeof(TTBucket), count, f) == count;
+        done += count;
+    }
+    AlignedFree(chunk);
+
+    if (fclose(f) != 0) ok = false;
+#ifdef _WIN32
+    if (ok) remove(path); /* rename doesn't replace an existing file here */
+#endif
+    if (!ok || rename(tmpPath, path) != 0) {
+        fprintf(stderr, "Error: Unable to write %s\n", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+/* Maps the whole file read-only; NULL if it can't be opened or is empty */
+static const void* MapSnapshot(const char* path, size_t* size)
+{
+    const void* mem = NULL;
+    *size = 0;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            mem = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping); /* The view keeps the mapping alive */
+            if (mem) *size = (size_t)fileSize.QuadPart;
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mem == MAP_FAILED) {
+            mem = NULL;
+        }
+        else {
+            *size = (size_t)st.st_size;
+            madvise((void*)mem, *size, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd); /* The mapping keeps the file open */
+#endif
+    return mem;
+}
+
+static void UnmapSnapshot(const void* mem, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(mem);
+#else
+    munmap((void*)mem, size);
+#endif
+}
+
+/*
+   LoadTranspositionTable:
+   - Checks the header against this build, reallocates the table if the
+     snapshot has another bucket count (without clearing: every bucket is
+     about to be overwritten), then copies the mapped buckets in.
+*/
+bool LoadTranspositionTable(TransTable* tt, const char* path)
+{
+    size_t size;
+    const unsigned char* mem = (const unsigned char*)MapSnapshot(path, &size);
+    if (!mem) {
+        fprintf(stderr, "Error: Unable to open %s\n", path);
+        return false;
+    }
+
+    TTFileHeader header;
+    const char* problem = NULL;
+    if (size < sizeof(header)) {
+        problem = "too short";
+    }
+    else {
+        memcpy(&header, mem, sizeof(header));
+        if (memcmp(header.magic, TT_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            problem = "not a hash snapshot";
+        }
+        else if (header.version != TT_FILE_VERSION || header.byteOrder != TT_FILE_BYTE_ORDER
+                 || header.bucketBytes != sizeof(TTBucket)) {
+            problem = "written by an incompatible version";
+        }
+        else if (header.zobristCheck != SideKey) {
+            problem = "written with different hash keys";
+        }
+        else if (header.numBuckets == 0
+                 || header.numBuckets > (size - sizeof(header)) / sizeof(TTBucket)
+                 || sizeof(header) + header.numBuckets * sizeof(TTBucket) != size) {
+            problem = "truncated or padded";
+        }
+    }
+    if (problem) {
+        fprintf(stderr, "Error: %s: %s\n", path, problem);
+        UnmapSnapshot(mem, size);
+        return false;
+    }
+
+    if (header.numBuckets != tt->numBuckets) {
+        size_t oldEntries = tt->numEntries;
+        FreeTranspositionTable(tt);
+        if (!AllocTable(tt, (size_t)header.numBuckets * sizeof(TTBucket))) {
+            fprintf(stderr, "Error: Unable to allocate memory for the %s snapshot\n", path);
+            UnmapSnapshot(mem, size);
+            InitTranspositionTable(tt, oldEntries);
+            return false;
+        }
+        tt->numBuckets = (size_t)header.numBuckets;
+        tt->numEntries = tt->numBuckets * TT_BUCKET_SIZE;
+    }
+
+    FillTable(tt, (const TTBucket*)(mem + sizeof(header)));
+    tt->age = (int)(header.age & TT_GEN_MASK);
+    UnmapSnapshot(mem, size);
+    return true;
+}
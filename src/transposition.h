@@ -14,11 +14,20 @@
    3) void StoreHashEntry(TransTable* tt, uint64_t key, int depth, int score,
                           int flag, Move bestMove);
    4) bool ProbeHashEntry(TransTable* tt, uint64_t key, int depth, int* outScore,
-                          Move* outMove);
+                          int* outFlag, Move* outMove);
+   5) void IncrementTTAge(TransTable* tt);
+   6) void ClearTranspositionTable(TransTable* tt);
+   7) bool ResizeTranspositionTable(TransTable* tt, size_t megabytes);
+   8) void PrefetchHashEntry(const TransTable* tt, uint64_t key);  (inline)
+   9) int HashFull(const TransTable* tt);
+   10) bool SaveTranspositionTable(const TransTable* tt, const char* path);
+   11) bool LoadTranspositionTable(TransTable* tt, const char* path);
 
    Data structures:
-   - TTEntry: holds Zobrist key, search depth, score, node type flag, best move, etc.
-   - TransTable: an array of TTEntry plus metadata.
+   - TTEntry: 8-byte compact entry (key check, move, score, depth, bound, age).
+   - TTBucket: one 64-byte cache line holding TT_BUCKET_SIZE entries.
+   - The table may be shared by all search threads without locking.
+   - TransTable: an array of buckets plus metadata.
 */
 
 #ifndef TRANSPOSITION_H
@@ -27,41 +36,92 @@
 #include <stdint.h>  /* For uint64_t */
 #include <stddef.h>  /* For size_t */
 #include <stdbool.h> /* For bool */
-#include "movegen.h" /* For the Move struct */
+#include "movegen.h" /* For the Move type */
+#include "misc.h"    /* For Prefetch */
 
-/* 
-   Structure for a single transposition table entry.
+/* Node type (bound) flags */
+#define TT_EXACT 0 /* Exact score */
+#define TT_ALPHA 1 /* Upper bound: score <= stored value (failed low) */
+#define TT_BETA  2 /* Lower bound: score >= stored value (failed high) */
+
+/* Entries per bucket; a bucket fills exactly one 64-byte cache line */
+#define TT_BUCKET_SIZE 8
+
+/* Table size limits for the UCI "Hash" option, in megabytes */
+#define TT_DEFAULT_MB 16
+#define TT_MAX_MB     65536
+
+/*
+   Structure for a single transposition table entry (8 bytes).
    Fields:
-    - key:     Zobrist hash key
-    - depth:   depth at which this entry was calculated
-    - score:   stored evaluation or alpha/beta window boundary
-    - flag:    node type (0=exact, 1=alpha, 2=beta, etc.)
-    - bestMove:the best move found in this position
-    - age:     to help with replacing old entries
+    - key16:    low 16 bits of the Zobrist key, to verify a slot match
+                (the bucket index is taken from the other bits)
+    - bestMove: the best move found in this position (NOMOVE if none)
+    - score:    stored evaluation or alpha/beta window boundary
+    - depth8:   depth + 1 at which this entry was calculated (0 = empty slot)
+    - genBound: search generation (upper 6 bits) and bound flag (lower 2 bits)
 */
 typedef struct {
-    uint64_t key;
-    int depth;
-    int score;
-    int flag;      /* e.g., 0=Exact, 1=Alpha, 2=Beta */
-    Move bestMove; /* optional best move in this position */
-    int age;       /* helps detect older entries to replace */
+    uint16_t key16;
+    Move     bestMove;
+    int16_t  score;
+    uint8_t  depth8;
+    uint8_t  genBound;
 } TTEntry;
 
+/*
+   A bucket keeps its entries as raw 64-bit words. Every entry is read and
+   written with one atomic word access, so threads sharing the table never
+   see an entry half-written by another thread (no torn reads).
+*/
+typedef struct {
+    _Alignas(64) uint64_t entries[TT_BUCKET_SIZE];
+} TTBucket;
+
 /*
    Structure for the entire transposition table:
-    - entries:   dynamically allocated array of TTEntry
-    - numEntries: number of entries allocated
-    - newWrite:   count how many times we've stored new data
-    - age:        increments each search iteration
+    - buckets:    64-byte-aligned array of buckets
+    - numBuckets: number of buckets allocated
+    - numEntries: total entry slots (numBuckets * TT_BUCKET_SIZE)
+    - age:        search generation (0..63), bumped once per search
+    - allocKind:  how the buckets were allocated (TT_ALLOC_*)
+    - allocSize:  bytes actually allocated (rounded up to the page size)
 */
+#define TT_ALLOC_HEAP  0 /* Aligned heap memory (maybe transparent huge pages) */
+#define TT_ALLOC_LARGE 1 /* Explicit large pages (mmap / VirtualAlloc) */
+
 typedef struct {
-    TTEntry* entries;
+    TTBucket* buckets;
+    size_t numBuckets;
     size_t numEntries;
-    int newWrite;
     int age;
+    int allocKind;
+    size_t allocSize;
 } TransTable;
 
+/* Maps key uniformly onto the table's buckets with a multiply-shift */
+static inline TTBucket* TTBucketFor(const TransTable* tt, uint64_t key)
+{
+#ifdef __SIZEOF_INT128__
+    size_t index = (size_t)(((unsigned __int128)key * tt->numBuckets) >> 64);
+#else
+    size_t index = (size_t)(((key >> 32) * (uint64_t)tt->numBuckets) >> 32);
+#endif
+    return &tt->buckets[index];
+}
+
+/*
+   Start loading the bucket of key into the cache. Called as soon as a
+   child position's key is known, so the DRAM access overlaps with the
+   work done before the child probes the table.
+*/
+static inline void PrefetchHashEntry(const TransTable* tt, uint64_t key)
+{
+    if (tt->buckets) {
+        Prefetch(TTBucketFor(tt, key));
+    }
+}
+
 /* Allocate and initialize the TT. size = desired number of entries. */
 void InitTranspositionTable(TransTable* tt, size_t size);
 
@@ -69,11 +129,46 @@ void InitTranspositionTable(TransTable* tt, size_t size);
 void FreeTranspositionTable(TransTable* tt);
 
 /* Store a new entry (or replace an older one) in the TT. */
-void StoreHashEntry(TransTable* tt, uint64_t key, int depth, int score, 
+void StoreHashEntry(TransTable* tt, uint64_t key, int depth, int score,
                     int flag, Move bestMove);
 
-/* Probe the TT for a matching entry with a key & sufficient depth. */
-bool ProbeHashEntry(TransTable* tt, uint64_t key, int depth, int* outScore, 
-                    Move* outMove);
+/*
+   Probe the TT for key. On a key match outMove is always filled (useful
+   for move ordering); returns true only if the entry's depth is >= depth,
+   in which case outScore and outFlag are filled too.
+*/
+bool ProbeHashEntry(TransTable* tt, uint64_t key, int depth, int* outScore,
+                    int* outFlag, Move* outMove);
+
+/* Start a new search generation, so older entries become replaceable. */
+void IncrementTTAge(TransTable* tt);
+
+/* Per mille of sampled slots filled by the current search, for "info hashfull" */
+int HashFull(const TransTable* tt);
+
+/* Empty every bucket (using several threads for big tables) and reset the age. */
+void ClearTranspositionTable(TransTable* tt);
+
+/*
+   Reallocate the table to the number of buckets that fits in megabytes MB
+   (the contents are lost). On allocation failure the previous size is
+   restored and false is returned.
+*/
+bool ResizeTranspositionTable(TransTable* tt, size_t megabytes);
+
+/*
+   Write the table to path as a snapshot (header + raw buckets, format in
+   transposition.c). Safe while a search is using the table. The snapshot
+   goes to path.tmp first and replaces path only once complete.
+*/
+bool SaveTranspositionTable(const TransTable* tt, const char* path);
+
+/*
+   Replace the table with a snapshot: the table takes the snapshot's size
+   and search generation. On a missing or incompatible file, or if the
+   memory for its size can't be had, false is returned and the table keeps
+   its size and contents (after a failed resize it is empty).
+*/
+bool LoadTranspositionTable(TransTable* tt, const char* path);
 
 #endif /* TRANSPOSITION_H */
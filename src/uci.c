@@ -11,21 +11,39 @@
 */
 
 #include "uci.h"
+#include "syzygy.h"
+#include "book.h"
 
+#include <ctype.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Engine options (set with "setoption") */
+static int NumThreads = 1; /* Search threads, main thread included */
+static bool UseNullMove = true; /* Selective search switches, for A/B tests */
+static bool UseLmr = true;
+static bool UseFutility = true;
+static bool UseCheckExtensions = true;
+static int SyzygyProbeLimit = 7; /* Most pieces to probe the tablebases with */
+static bool OwnBook = false;     /* Play book moves without searching */
+static int MultiPV = 1;          /* Best lines to search and report */
+
 /*
     UciLoop:
     - Continuously reads lines from stdin.
-    - Breaks on "quit" command or EOF.
+    - Breaks on "quit" command or EOF, stopping any running search.
+    - Searches run on their own thread, so "stop" and "isready" are
+      answered while the engine is thinking.
     - Calls ParseUciCommand for each line.
 */
 void UciLoop(Board* board, TransTable* tt)
 {
     char line[1024];
 
+    /* GUIs read us through a pipe: make every line reach them at once */
+    setvbuf(stdout, NULL, _IONBF, 0);
+
     while (true) {
         /* Clear the line buffer before reading */
         memset(line, 0, sizeof(line));
@@ -47,13 +65,18 @@ void UciLoop(Board* board, TransTable* tt)
         /* Parse the command */
         ParseUciCommand(line, board, tt);
     }
+
+    /* Don't leave a search running on quit or EOF */
+    StopSearch();
+    WaitForSearch();
 }
 
 /*
     ParseUciCommand:
     - Identifies UCI commands from the input line and
       performs corresponding actions.
-    - Handles commands: "uci", "isready", "position", "go", "stop", "ucinewgame".
+    - Handles commands: "uci", "isready", "setoption", "position", "go", "stop",
+      "ucinewgame".
 */
 void ParseUciCommand(const char* line, Board* board, TransTable* tt)
 {
@@ -62,15 +85,154 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
     if (!strcmp(line, "uci")) {
         printf("id name Bear 0.01\n");
         printf("id author ChatGPT o1\n");
+        printf("option name Threads type spin default 1 min 1 max %d\n", MAX_THREADS);
+        printf("option name Hash type spin default %d min 1 max %d\n", TT_DEFAULT_MB, TT_MAX_MB);
+        printf("option name Clear Hash type button\n");
+        printf("option name MultiPV type spin default 1 min 1 max %d\n", MAX_MULTIPV);
+        printf("option name Ponder type check default false\n");
+        printf("option name EvalFile type string default <empty>\n");
+        printf("option name Use NNUE type check default true\n");
+        printf("option name Debug Log File type string default <empty>\n");
+        printf("option name OwnBook type check default false\n");
+        printf("option name BookFile type string default <empty>\n");
+        printf("option name SyzygyPath type string default <empty>\n");
+        printf("option name SyzygyProbeLimit type spin default 7 min 0 max 7\n");
+        printf("option name Null Move Pruning type check default true\n");
+        printf("option name Late Move Reductions type check default true\n");
+        printf("option name Futility Pruning type check default true\n");
+        printf("option name Check Extensions type check default true\n");
         printf("uciok\n");
-        LogMessage(LOG_INFO, "Handled 'uci' command.\n");
+        LogInfo("Handled 'uci' command.\n");
     }
     /* "isready" command:
        - Engine must respond "readyok" when fully ready. */
     else if (!strcmp(line, "isready")) {
         /* Perform any necessary preparations here */
         printf("readyok\n");
-        LogMessage(LOG_INFO, "Handled 'isready' command.\n");
+        LogInfo("Handled 'isready' command.\n");
+    }
+    /* "setoption" command:
+       - "setoption name <id> [value <x>]"; option names may contain spaces.
+    */
+    else if (!strncmp(line, "setoption", 9)) {
+        const char* namePtr  = strstr(line, "name ");
+        const char* valuePtr = strstr(line, " value ");
+        if (!namePtr) {
+            LogWarn("Malformed setoption: %s\n", line);
+            return;
+        }
+        namePtr += 5;
+
+        char name[64] = {0};
+        size_t nameLen = valuePtr ? (size_t)(valuePtr - namePtr) : strlen(namePtr);
+        if (nameLen >= sizeof(name)) nameLen = sizeof(name) - 1;
+        memcpy(name, namePtr, nameLen);
+        const char* value = valuePtr ? valuePtr + 7 : "";
+
+        /* Options only change between searches; an infinite or ponder
+           search would never finish on its own */
+        StopSearch();
+        WaitForSearch();
+
+        if (!strcmp(name, "Threads")) {
+            int threads = atoi(value);
+            if (threads < 1) threads = 1;
+            if (threads > MAX_THREADS) threads = MAX_THREADS;
+            NumThreads = threads;
+            LogInfo("Threads set to %d.\n", NumThreads);
+        }
+        else if (!strcmp(name, "MultiPV")) {
+            int lines = atoi(value);
+            if (lines < 1) lines = 1;
+            if (lines > MAX_MULTIPV) lines = MAX_MULTIPV;
+            MultiPV = lines;
+            LogInfo("MultiPV set to %d.\n", MultiPV);
+        }
+        else if (!strcmp(name, "Ponder")) {
+            /* Only tells us the GUI may send "go ponder"; nothing to set up */
+            LogInfo("Ponder set to %s.\n", value);
+        }
+        else if (!strcmp(name, "Null Move Pruning")) {
+            UseNullMove = !strcmp(value, "true");
+            LogInfo("Null Move Pruning set to %s.\n", value);
+        }
+        else if (!strcmp(name, "Late Move Reductions")) {
+            UseLmr = !strcmp(value, "true");
+            LogInfo("Late Move Reductions set to %s.\n", value);
+        }
+        else if (!strcmp(name, "Futility Pruning")) {
+            UseFutility = !strcmp(value, "true");
+            LogInfo("Futility Pruning set to %s.\n", value);
+        }
+        else if (!strcmp(name, "Check Extensions")) {
+            UseCheckExtensions = !strcmp(value, "true");
+            LogInfo("Check Extensions set to %s.\n", value);
+        }
+        else if (!strcmp(name, "Debug Log File")) {
+            const char* path = strcmp(value, "<empty>") ? value : "";
+            if (!SetLogFile(path)) {
+                printf("info string Could not open log file %s\n", path);
+            }
+            LogInfo("Debug Log File set to %s.\n", path);
+        }
+        else if (!strcmp(name, "Hash")) {
+            long megabytes = atol(value);
+            if (megabytes < 1) megabytes = 1;
+            if (megabytes > TT_MAX_MB) megabytes = TT_MAX_MB;
+            if (!ResizeTranspositionTable(tt, (size_t)megabytes)) {
+                printf("info string Could not allocate %ld MB of hash, keeping %zu MB\n",
+                       megabytes, tt->numEntries * sizeof(TTEntry) / (1024 * 1024));
+            }
+            LogInfo("Hash set to %ld MB (%zu entries).\n", megabytes, tt->numEntries);
+        }
+        else if (!strcmp(name, "Clear Hash")) {
+            ClearTranspositionTable(tt);
+            LogInfo("Hash cleared.\n");
+        }
+        else if (!strcmp(name, "EvalFile")) {
+            if (NnueLoad(value)) {
+                printf("info string Loaded NNUE net %s\n", value);
+            }
+            else if (value[0] && strcmp(value, "<empty>")) {
+                printf("info string Could not load NNUE net %s\n", value);
+            }
+            printf("info string Using %s evaluation\n", NnueEnabled ? "NNUE" : "classical");
+            LogInfo("EvalFile set to %s.\n", value);
+        }
+        else if (!strcmp(name, "OwnBook")) {
+            OwnBook = !strcmp(value, "true");
+            LogInfo("OwnBook set to %s.\n", value);
+        }
+        else if (!strcmp(name, "BookFile")) {
+            if (!BookOpen(value)) {
+                printf("info string Could not open book %s\n", value);
+            }
+            LogInfo("BookFile set to %s.\n", value);
+        }
+        else if (!strcmp(name, "SyzygyPath")) {
+            if (TbInit(value) && TbLargest() > 0) {
+                printf("info string Found %d-piece Syzygy tablebases\n", TbLargest());
+            }
+            else if (value[0] && strcmp(value, "<empty>")) {
+                printf("info string No Syzygy tablebases available from %s\n", value);
+            }
+            LogInfo("SyzygyPath set to %s.\n", value);
+        }
+        else if (!strcmp(name, "SyzygyProbeLimit")) {
+            int limit = atoi(value);
+            if (limit < 0) limit = 0;
+            if (limit > 7) limit = 7;
+            SyzygyProbeLimit = limit;
+            LogInfo("SyzygyProbeLimit set to %d.\n", SyzygyProbeLimit);
+        }
+        else if (!strcmp(name, "Use NNUE")) {
+            NnueSetEnabled(!strcmp(value, "true"));
+            printf("info string Using %s evaluation\n", NnueEnabled ? "NNUE" : "classical");
+            LogInfo("Use NNUE set to %s.\n", value);
+        }
+        else {
+            LogWarn("Unknown option: %s\n", name);
+        }
     }
     /* "position" command:
        - Example: "position startpos moves e2e4 e7e5"
@@ -78,7 +240,7 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
        - Parses the position and updates the board accordingly.
     */
     else if (!strncmp(line, "position", 8)) {
-        LogMessage(LOG_DEBUG, "Handling 'position' command: %s\n", line);
+        LogDebug("Handling 'position' command: %s\n", line);
         
         /* Tokenize the input */
         char copy[1024];
@@ -90,15 +252,16 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
 
         if (token && !strcmp(token, "startpos")) {
             InitBoard(board);
-            LogMessage(LOG_DEBUG, "Initialized board to start position.\n");
+            LogDebug("Initialized board to start position.\n");
             token = strtok(NULL, " "); /* Check for "moves" */
         }
         else if (token && !strcmp(token, "fen")) {
             char fen[256] = {0};
             token = strtok(NULL, " "); /* Start of FEN string */
             if (token) {
-                /* Reconstruct the full FEN string */
-                while (token && strlen(fen) < sizeof(fen) - 1) {
+                /* Reconstruct the full FEN string, up to "moves" */
+                while (token && strcmp(token, "moves") &&
+                       strlen(fen) + strlen(token) + 1 < sizeof(fen)) {
                     strcat(fen, token);
                     strcat(fen, " ");
                     token = strtok(NULL, " ");
@@ -109,23 +272,22 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
                     fen[len-1] = '\0';
                 }
                 SetFen(board, fen, true); /* Assuming debugMode is enabled */
-                LogMessage(LOG_DEBUG, "Set board from FEN: %s\n", fen);
+                LogDebug("Set board from FEN: %s\n", fen);
             }
         }
 
-        /* Handle "moves" if present */
-        token = strtok(NULL, " ");
+        /* Handle "moves" if present (token is already past the position) */
         if (token && !strcmp(token, "moves")) {
-            LogMessage(LOG_DEBUG, "Applying moves from 'position' command.\n");
+            LogDebug("Applying moves from 'position' command.\n");
             while ((token = strtok(NULL, " ")) != NULL) {
                 /* Convert UCI move string to Move struct */
                 Move move = UciMoveToMove(board, token);
                 if (IsMoveLegal(board, move)) {
                     MakeMove(board, move);
-                    LogMessage(LOG_DEBUG, "Applied move: %s\n", token);
+                    LogDebug("Applied move: %s\n", token);
                 }
                 else {
-                    LogMessage(LOG_WARN, "Illegal move attempted: %s\n", token);
+                    LogWarn("Illegal move attempted: %s\n", token);
                 }
             }
         }
@@ -135,11 +297,19 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
        - Parses optional parameters like time controls or depth.
     */
     else if (!strncmp(line, "go", 2)) {
-        LogMessage(LOG_DEBUG, "Handling 'go' command: %s\n", line);
+        LogDebug("Handling 'go' command: %s\n", line);
         
         /* Initialize SearchInfo */
         SearchInfo info;
         ClearSearchInfo(&info);
+        info.threads = NumThreads;
+        info.tt      = tt;
+        info.multiPV = MultiPV;
+        info.nullMove        = UseNullMove;
+        info.lmr             = UseLmr;
+        info.futility        = UseFutility;
+        info.checkExtensions = UseCheckExtensions;
+        info.tbPieces = (TbLargest() < SyzygyProbeLimit) ? TbLargest() : SyzygyProbeLimit;
         
         /* Parse the "go" command parameters */
         char copy[1024];
@@ -154,54 +324,181 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
                 token = strtok(NULL, " ");
                 if (token) {
                     info.depth = atoi(token);
-                    LogMessage(LOG_DEBUG, "Search depth set to %d.\n", info.depth);
+                    LogDebug("Search depth set to %d.\n", info.depth);
                 }
             }
             else if (!strcmp(token, "movetime")) {
                 token = strtok(NULL, " ");
                 if (token) {
                     info.movetime = atoi(token); /* Assuming SearchInfo has movetime */
-                    LogMessage(LOG_DEBUG, "Search movetime set to %d ms.\n", info.movetime);
+                    LogDebug("Search movetime set to %d ms.\n", info.movetime);
+                }
+            }
+            else if (!strcmp(token, "nodes")) {
+                token = strtok(NULL, " ");
+                if (token) {
+                    info.nodeLimit = strtoull(token, NULL, 10);
+                    LogDebug("Search node limit set to %llu.\n", (unsigned long long)info.nodeLimit);
+                }
+            }
+            else if (!strcmp(token, "infinite")) {
+                info.infinite = true;
+                LogDebug("Infinite search requested.\n");
+            }
+            else if (!strcmp(token, "ponder")) {
+                info.ponder = true;
+                LogDebug("Pondering requested.\n");
+            }
+            /* "searchmoves <move1> ... <movei>": the list ends at the first
+               token that isn't a legal move, which is the next parameter */
+            else if (!strcmp(token, "searchmoves")) {
+                while ((token = strtok(NULL, " ")) != NULL) {
+                    /* No UCI keyword starts with a square */
+                    if (token[0] < 'a' || token[0] > 'h' || token[1] < '1' || token[1] > '8') {
+                        break;
+                    }
+                    Move move = UciMoveToMove(board, token);
+                    if (move == NOMOVE || !IsMoveLegal(board, move)) {
+                        break;
+                    }
+                    if (info.searchMoveCount < MAX_POSITION_MOVES) {
+                        info.searchMoves[info.searchMoveCount++] = move;
+                    }
+                }
+                LogDebug("Root search restricted to %d moves.\n", info.searchMoveCount);
+                continue; /* token already holds the next parameter */
+            }
+            /* Clock: only the side to move's time and increment matter */
+            else if (!strcmp(token, "wtime") || !strcmp(token, "btime")) {
+                int side = (token[0] == 'w') ? WHITE : BLACK;
+                token = strtok(NULL, " ");
+                if (token && side == board->side) {
+                    info.timeLeft = atoi(token);
+                }
+            }
+            else if (!strcmp(token, "winc") || !strcmp(token, "binc")) {
+                int side = (token[0] == 'w') ? WHITE : BLACK;
+                token = strtok(NULL, " ");
+                if (token && side == board->side) {
+                    info.increment = atoi(token);
+                }
+            }
+            else if (!strcmp(token, "movestogo")) {
+                token = strtok(NULL, " ");
+                if (token) {
+                    info.movesToGo = atoi(token);
                 }
             }
-            // Handle other parameters like wtime, btime, etc.
-            // ...
+            if (!token) break;
             token = strtok(NULL, " ");
         }
 
-        /* Start the search (this is a blocking call) */
-        int score = SearchPosition(board, &info);
-        LogMessage(LOG_DEBUG, "Search completed with score: %d.\n", score);
+        /* A book move needs no search; analysis ("go infinite") always
+           searches, and a ponder search must not answer before "ponderhit" */
+        if (OwnBook && !info.infinite && !info.ponder) {
+            Move bookMove = BookProbe(board);
+            if (bookMove != NOMOVE) {
+                char moveStr[6];
+                StopSearch();
+                WaitForSearch();
+                MoveToUciMove(bookMove, moveStr);
+                printf("info string book move\n");
+                printf("bestmove %s\n", moveStr);
+                return;
+            }
+        }
 
-        /* Output the best move */
-        char bestMoveStr[10];
-        MoveToUciMove(info.bestMove, bestMoveStr); /* Convert Move struct to UCI string */
-        printf("bestmove %s\n", bestMoveStr);
-        LogMessage(LOG_INFO, "Best move: %s\n", bestMoveStr);
+        /* Start the search on its own thread; it prints "bestmove" itself */
+        StartSearch(board, &info);
     }
     /* "stop" command:
        - Tells engine to stop searching immediately and output the best move found. */
     else if (!strcmp(line, "stop")) {
-        LogMessage(LOG_DEBUG, "Handling 'stop' command.\n");
-        /* Implement search stopping mechanism here */
-        /* Example: set info.stopped = true; */
-        /* Then, after search detects the stop, it should output the best move */
+        LogDebug("Handling 'stop' command.\n");
+        /* The search thread notices within a few thousand nodes and
+           prints the best move found so far */
+        StopSearch();
+    }
+    /* "ponderhit" command:
+       - The opponent played the expected move: the ponder search goes on
+         as a normal search and prints "bestmove" when its time is up.
+         On a miss the GUI sends "stop" instead, and the TT keeps what
+         the ponder search found for the next search. */
+    else if (!strcmp(line, "ponderhit")) {
+        LogDebug("Handling 'ponderhit' command.\n");
+        PonderHit();
     }
     /* "ucinewgame" command:
        - Signals a new game is about to start. Typically we reset the board,
          transposition table, search stats, etc. */
     else if (!strcmp(line, "ucinewgame")) {
-        LogMessage(LOG_INFO, "Handling 'ucinewgame' command.\n");
+        LogInfo("Handling 'ucinewgame' command.\n");
+        StopSearch();
+        WaitForSearch();
         /* Reset the board */
         InitBoard(board);
-        /* Optionally clear the transposition table */
-        /* FreeTranspositionTable(tt);
-           InitTranspositionTable(tt, tt->numEntries); */
-        /* Reset search statistics if any */
+        /* Results from the previous game must not leak into this one */
+        ClearTranspositionTable(tt);
+    }
+    /* "perft <depth>" / "divide <depth>" (engine extensions):
+       - Count legal move paths from the current position and report
+         nodes, time and NPS. "divide" also lists the count per root move. */
+    else if (!strncmp(line, "perft", 5) || !strncmp(line, "divide", 6)) {
+        bool divide = (line[0] == 'd');
+        const char* arg = strchr(line, ' ');
+        int depth = arg ? atoi(arg + 1) : 0;
+        LogDebug("Handling '%s' command, depth %d.\n", divide ? "divide" : "perft", depth);
+        StopSearch();
+        WaitForSearch();
+        PerftCommand(board, depth, divide);
+    }
+    /* "bench [depth] [threads] [hashMB]" (engine extension):
+       - Searches the built-in bench positions with a private hash table
+         (the current position and Hash are left alone) and reports the
+         node count signature, time and NPS. */
+    else if (!strcmp(line, "bench") || !strncmp(line, "bench ", 6)) {
+        int depth = 0, threads = 0, hashMb = 0;
+        sscanf(line + 5, "%d %d %d", &depth, &threads, &hashMb);
+        LogDebug("Handling 'bench' command.\n");
+        StopSearch();
+        WaitForSearch();
+        RunBench(depth, threads, hashMb > 0 ? (size_t)hashMb : 0);
+    }
+    /* "savehash <file>" / "loadhash <file>" (engine extensions):
+       - Save the hash table to a snapshot file, or replace it with one
+         (the table takes the snapshot's size), so a long analysis can
+         resume where it stopped. Saving doesn't disturb a running search;
+         loading stops it first. */
+    else if (!strncmp(line, "savehash ", 9) || !strncmp(line, "loadhash ", 9)) {
+        bool save = (line[0] == 's');
+        const char* path = line + 9;
+        while (*path == ' ') path++;
+        LogDebug("Handling '%s' command: %s\n", save ? "savehash" : "loadhash", path);
+        if (save) {
+            if (!SaveTranspositionTable(tt, path)) {
+                printf("info string Could not save the hash to %s\n", path);
+            }
+            else {
+                printf("info string Saved %zu MB of hash to %s\n",
+                       tt->numEntries * sizeof(TTEntry) / (1024 * 1024), path);
+            }
+        }
+        else {
+            StopSearch();
+            WaitForSearch();
+            if (!LoadTranspositionTable(tt, path)) {
+                printf("info string Could not load the hash from %s\n", path);
+            }
+            else {
+                printf("info string Loaded %zu MB of hash from %s\n",
+                       tt->numEntries * sizeof(TTEntry) / (1024 * 1024), path);
+            }
+        }
+        fflush(stdout);
     }
     /* Otherwise, it's an unknown or unhandled command. */
     else {
-        LogMessage(LOG_WARN, "Received unknown command: %s\n", line);
+        LogWarn("Received unknown command: %s\n", line);
         /* Optionally, you can respond with something or ignore */
     }
 }
@@ -212,22 +509,18 @@ void ParseUciCommand(const char* line, Board* board, TransTable* tt)
 
 /*
     UciMoveToMove:
-    - Converts a UCI move string (e.g., "e2e4") to a Move struct.
+    - Converts a UCI move string (e.g., "e2e4") to a packed Move.
     - Handles promotions (e.g., "e7e8q").
+    - Capture, double push, en passant and castling flags are taken from
+      the board, since the string does not carry them.
+    - Returns NOMOVE if the string is malformed.
 */
 Move UciMoveToMove(Board* board, const char* uci)
 {
-    Move move = {0};
-    /* Example implementation:
-       - Convert file/rank to square indices
-       - Handle promotions
-       - Set flags if necessary (e.g., en passant, castling)
-    */
-
     /* Basic parsing for from and to squares */
     if (strlen(uci) < 4) {
-        LogMessage(LOG_ERROR, "Invalid UCI move format: %s\n", uci);
-        return move;
+        LogError("Invalid UCI move format: %s\n", uci);
+        return NOMOVE;
     }
 
     int fromFile = uci[0] - 'a';
@@ -235,74 +528,65 @@ Move UciMoveToMove(Board* board, const char* uci)
     int toFile   = uci[2] - 'a';
     int toRank   = uci[3] - '1';
 
-    move.from = FRTo120(fromFile, fromRank);
-    move.to   = FRTo120(toFile, toRank);
+    if (fromFile < 0 || fromFile > 7 || fromRank < 0 || fromRank > 7 ||
+        toFile < 0 || toFile > 7 || toRank < 0 || toRank > 7) {
+        LogError("Invalid UCI move squares: %s\n", uci);
+        return NOMOVE;
+    }
+
+    int from  = FRToSq(fromFile, fromRank);
+    int to    = FRToSq(toFile, toRank);
+    int piece = board->pieces[from];
+    int flags = (board->pieces[to] != EMPTY) ? MFLAG_CAPTURE : MFLAG_QUIET;
 
     /* Handle promotion */
     if (strlen(uci) == 5) {
         char promo = tolower(uci[4]);
         switch(promo) {
-            case 'q': move.promoted = (board->side == WHITE) ? W_QUEEN : B_QUEEN; break;
-            case 'r': move.promoted = (board->side == WHITE) ? W_ROOK  : B_ROOK;  break;
-            case 'b': move.promoted = (board->side == WHITE) ? W_BISHOP: B_BISHOP; break;
-            case 'n': move.promoted = (board->side == WHITE) ? W_KNIGHT: B_KNIGHT; break;
+            case 'q': flags |= MFLAG_PROMO | (QUEEN  - KNIGHT); break;
+            case 'r': flags |= MFLAG_PROMO | (ROOK   - KNIGHT); break;
+            case 'b': flags |= MFLAG_PROMO | (BISHOP - KNIGHT); break;
+            case 'n': flags |= MFLAG_PROMO | (KNIGHT - KNIGHT); break;
             default:
-                move.promoted = EMPTY;
-                LogMessage(LOG_WARN, "Unknown promotion piece: %c\n", promo);
+                LogWarn("Unknown promotion piece: %c\n", promo);
                 break;
         }
-        move.flag |= (1 << 3); /* Promotion flag */
     }
 
-    /* Add additional logic for en passant, castling, etc. */
+    /* Fill in what the move string leaves implicit */
+    if (piece == W_PAWN || piece == B_PAWN) {
+        if (to == board->enPas) {
+            flags = MFLAG_EP;
+        }
+        else if (abs(to - from) == 16) {
+            flags = MFLAG_PAWNSTART;
+        }
+    }
+    else if ((piece == W_KING || piece == B_KING) && abs(to - from) == 2) {
+        flags = (to > from) ? MFLAG_KING_CASTLE : MFLAG_QUEEN_CASTLE;
+    }
 
-    return move;
+    return EncodeMove(from, to, flags);
 }
 
 /*
     MoveToUciMove:
-    - Converts a Move struct to a UCI move string (e.g., "e2e4").
+    - Converts a Move to a UCI move string (e.g., "e2e4").
     - Handles promotions (e.g., "e7e8q").
 */
 void MoveToUciMove(Move move, char* uci)
 {
-    /* Example implementation:
-       - Convert square indices back to file/rank
-       - Append promotion character if necessary
-    */
-
     /* Basic conversion for from and to squares */
-    int fromFile = (move.from % 10) - 1;
-    int fromRank = (move.from / 10) - 2;
-    int toFile   = (move.to % 10) - 1;
-    int toRank   = (move.to / 10) - 2;
+    int fromFile = FILE_OF(FromSq(move));
+    int fromRank = RANK_OF(FromSq(move));
+    int toFile   = FILE_OF(ToSq(move));
+    int toRank   = RANK_OF(ToSq(move));
 
     sprintf(uci, "%c%d%c%d", 'a' + fromFile, 1 + fromRank, 'a' + toFile, 1 + toRank);
 
     /* Handle promotion */
-    if (move.flag & (1 << 3)) { /* Promotion flag */
-        char promo = 'q'; /* Default to queen */
-        switch(move.promoted) {
-            case W_ROOK:
-            case B_ROOK:
-                promo = 'r';
-                break;
-            case W_BISHOP:
-            case B_BISHOP:
-                promo = 'b';
-                break;
-            case W_KNIGHT:
-            case B_KNIGHT:
-                promo = 'n';
-                break;
-            case W_QUEEN:
-            case B_QUEEN:
-            default:
-                promo = 'q';
-                break;
-        }
-        sprintf(uci + strlen(uci), "%c", promo);
+    if (IsPromotion(move)) {
+        static const char PromoChars[7] = { 0, 0, 'n', 'b', 'r', 'q', 0 };
+        sprintf(uci + strlen(uci), "%c", PromoChars[PromotedType(move)]);
     }
-
-    /* Add additional logic for en passant, castling, etc. */
 }
@@ -21,6 +21,8 @@
 #include "evaluate.h"
 #include "log.h" /* For logging */
 #include "move.h" /* Ensure Move is defined */
+#include "perft.h"
+#include "bench.h"
 
 void UciLoop(Board* board, TransTable* tt);
 void ParseUciCommand(const char* line, Board* board, TransTable* tt);
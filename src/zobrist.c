@@ -0,0 +1,94 @@
+/****************************************************************************
+ * File: zobrist.c
+ ****************************************************************************/
+/*
+    Description:
+    - Implementation of Zobrist hashing.
+    - The keys come from a fixed-seed xorshift64* generator, so the same
+      position always hashes to the same key from run to run.
+*/
+
+#include "zobrist.h"
+#include "board.h"
+
+uint64_t PieceKeys[13][BOARD_SIZE];
+uint64_t EnPasKeys[BOARD_SIZE];
+uint64_t CastleKeys[16];
+uint64_t SideKey;
+
+/* xorshift64* pseudo-random generator with a fixed seed */
+static uint64_t Rand64(void)
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+    InitZobrist:
+    - Fills every key table with random 64-bit values.
+*/
+void InitZobrist(void)
+{
+    for(int piece = 0; piece < 13; piece++) {
+        for(int sq = 0; sq < BOARD_SIZE; sq++) {
+            PieceKeys[piece][sq] = Rand64();
+        }
+    }
+    for(int sq = 0; sq < BOARD_SIZE; sq++) {
+        EnPasKeys[sq] = Rand64();
+    }
+    for(int i = 0; i < 16; i++) {
+        CastleKeys[i] = Rand64();
+    }
+    SideKey = Rand64();
+}
+
+/*
+    GeneratePosKey:
+    - Builds the key from scratch by scanning the board.
+    - Used when a position is set up and by the debug-build consistency check.
+*/
+uint64_t GeneratePosKey(const Board* b)
+{
+    uint64_t key = 0ULL;
+
+    for(int sq = 0; sq < BOARD_SIZE; sq++) {
+        int piece = b->pieces[sq];
+        if(piece != EMPTY) {
+            key ^= PieceKeys[piece][sq];
+        }
+    }
+
+    if(b->side == BLACK) {
+        key ^= SideKey;
+    }
+    if(b->enPas != NO_SQ) {
+        key ^= EnPasKeys[b->enPas];
+    }
+    key ^= CastleKeys[b->castlePerm];
+
+    return key;
+}
+
+/*
+    GeneratePawnKey:
+    - Same as GeneratePosKey, restricted to the pawns of both sides.
+*/
+uint64_t GeneratePawnKey(const Board* b)
+{
+    uint64_t key = 0ULL;
+
+    Bitboard bb = b->pieceBB[W_PAWN];
+    while(bb) {
+        key ^= PieceKeys[W_PAWN][PopLsb(&bb)];
+    }
+    bb = b->pieceBB[B_PAWN];
+    while(bb) {
+        key ^= PieceKeys[B_PAWN][PopLsb(&bb)];
+    }
+
+    return key;
+}
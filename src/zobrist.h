@@ -0,0 +1,37 @@
+/****************************************************************************
+ * File: zobrist.h
+ ****************************************************************************/
+/*
+    Description:
+    - Header for Zobrist hashing.
+    - Declares the random key tables used to build a 64-bit position key
+      from pieces, side to move, castling rights and en passant square.
+    - The key is computed from scratch once (GeneratePosKey) and then kept
+      up to date incrementally by MakeMove/UnmakeMove.
+    - A second key over the pawns alone indexes the pawn hash table.
+*/
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+#include "defs.h"
+
+struct Board;
+
+/* Random keys, filled in once by InitZobrist() */
+extern uint64_t PieceKeys[13][BOARD_SIZE]; /* [piece][square] */
+extern uint64_t EnPasKeys[BOARD_SIZE];     /* [en passant square] */
+extern uint64_t CastleKeys[16];            /* [castlePerm] */
+extern uint64_t SideKey;                   /* XORed in when black is to move */
+
+/* Fill the key tables. Must be called once before any board is set up. */
+void InitZobrist(void);
+
+/* Compute the full position key of a board from scratch. */
+uint64_t GeneratePosKey(const struct Board* b);
+
+/* Compute the pawn-only key (the pawn entries of PieceKeys) from scratch. */
+uint64_t GeneratePawnKey(const struct Board* b);
+
+#endif /* ZOBRIST_H */